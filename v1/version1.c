@@ -14,9 +14,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
-#include <fcntl.h>
 #include <termios.h>
 #include <string.h>
+#include <stdbool.h>
+#include <poll.h>
+#include <signal.h>
 
 /**
 *
@@ -45,6 +47,31 @@
 */
 #define TAILLE_SERPENT 10
 
+/**
+*
+* \def TAILLE_CLAVIER
+*
+* \brief constante pour le nombre de touches en attente.
+*
+*/
+#define TAILLE_CLAVIER 64
+
+/**
+ * \brief État du clavier.
+ * 
+ * Le terminal passe une seule fois en mode non canonique sans écho,
+ * les touches lues sont gardées ici jusqu'à leur traitement.
+ */
+typedef struct {
+    struct termios ancien;         /** réglages du terminal à restaurer */
+    bool actif;                    /** le terminal est en mode non canonique */
+    char touches[TAILLE_CLAVIER];  /** touches lues et pas encore traitées */
+    int debut;                     /** indice de la prochaine touche à traiter */
+    int fin;                       /** indice de fin des touches en attente */
+} t_clavier;
+
+t_clavier clavier;
+
 /**
  * \brief Affiche un caractère à une position donnée.
  * 
@@ -80,7 +107,37 @@ void dessinerSerpent(int lesX[], int lesY[], int taille_actuelle);
  */
 void progresser(int lesX[], int lesY[], int *taille_actuelle);
 
-int kbhit();
+/**
+ * \brief Passe le terminal en mode non canonique sans écho jusqu'à la fin du programme.
+ */
+void initClavier();
+
+/**
+ * \brief Restaure les réglages d'origine du terminal.
+ */
+void restaurerClavier();
+
+/**
+ * \brief Restaure le terminal puis termine le programme à la réception d'un signal.
+ * 
+ * \param signal Le signal reçu.
+ */
+void signalArret(int signal);
+
+/**
+ * \brief Indique si une touche est disponible, en attendant au plus le délai donné.
+ * 
+ * \param attente Délai maximum en millisecondes (-1 pour attendre sans limite).
+ * \return true si une touche peut être lue avec lireTouche().
+ */
+bool toucheDisponible(int attente);
+
+/**
+ * \brief Retire la prochaine touche en attente.
+ * 
+ * \return La touche.
+ */
+char lireTouche();
 
 int main()
 {
@@ -132,6 +189,9 @@ int main()
 
     system("clear");
 
+    /** Le terminal reste en mode non canonique pendant toute la partie */
+    initClavier();
+
     /** Initialisation de la taille actuelle du serpent */
     taille_actuelle = lesX[0] < TAILLE_SERPENT ? lesX[0] : TAILLE_SERPENT;
 
@@ -155,6 +215,7 @@ int main()
         progresser(lesX, lesY, &taille_actuelle);
         dessinerSerpent(lesX, lesY, taille_actuelle);
         
+        fflush(stdout); /** envoie l'affichage avant d'attendre. */
         usleep(200000);
         
         /**
@@ -162,43 +223,120 @@ int main()
         * Condition vérifiant si l'utilisateur a appuyé sur une touche.
         *
         */
-        if (kbhit()) 
+        if (toucheDisponible(0)) 
         {
-            key = getchar(); /** récupère la touche saisie par l'utilisateur. */
+            key = lireTouche(); /** récupère la touche saisie par l'utilisateur. */
         }
     }
 
+    restaurerClavier();
     return EXIT_SUCCESS;
 }
 
 /**
- * \brief Vérifie si une touche a été pressée.
+ * \brief Passe le terminal en mode non canonique sans écho jusqu'à la fin du programme.
+ * 
+ * Les réglages d'origine sont restaurés à la sortie du programme
+ * ainsi qu'à la réception d'un signal d'arrêt.
+ */
+void initClavier(){
+    struct termios tty;
+    struct sigaction action;
+
+    if (tcgetattr(STDIN_FILENO, &clavier.ancien) == -1) {
+        perror("tcgetattr");
+        exit(EXIT_FAILURE);
+    }
+
+    tty = clavier.ancien;
+    tty.c_lflag &= ~(ICANON | ECHO);
+    tty.c_cc[VMIN] = 1;
+    tty.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1) {
+        perror("tcsetattr");
+        exit(EXIT_FAILURE);
+    }
+    clavier.actif = true;
+    clavier.debut = 0;
+    clavier.fin = 0;
+
+    atexit(restaurerClavier);
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = signalArret;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGHUP, &action, NULL);
+    sigaction(SIGQUIT, &action, NULL);
+}
+
+/**
+ * \brief Restaure les réglages d'origine du terminal.
+ */
+void restaurerClavier(){
+    if (clavier.actif) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &clavier.ancien);
+        clavier.actif = false;
+    }
+}
+
+/**
+ * \brief Restaure le terminal puis termine le programme à la réception d'un signal.
+ * 
+ * \param signal Le signal reçu.
+ */
+void signalArret(int signal){
+    struct sigaction action;
+
+    restaurerClavier();
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_DFL;
+    sigaction(signal, &action, NULL);
+    raise(signal);
+}
+
+/**
+ * \brief Indique si une touche est disponible, en attendant au plus le délai donné.
+ * 
+ * Si aucune touche n'est en attente, l'entrée est surveillée avec poll()
+ * puis toutes les touches disponibles sont lues en un seul read().
+ * 
+ * \param attente Délai maximum en millisecondes (-1 pour attendre sans limite).
+ * \return true si une touche peut être lue avec lireTouche().
+ */
+bool toucheDisponible(int attente){
+    struct pollfd entree = { .fd = STDIN_FILENO, .events = POLLIN };
+    ssize_t n;
+
+    if (clavier.debut < clavier.fin) {
+        return true;
+    }
+    clavier.debut = 0;
+    clavier.fin = 0;
+    if (poll(&entree, 1, attente) <= 0) {
+        return false;
+    }
+
+    n = read(STDIN_FILENO, clavier.touches, TAILLE_CLAVIER);
+    if (n == 0) { /** l'entrée est fermée : on arrête le programme. */
+        clavier.touches[0] = 'a';
+        n = 1;
+    }
+    if (n < 0) {
+        return false;
+    }
+    clavier.fin = n;
+    return true;
+}
+
+/**
+ * \brief Retire la prochaine touche en attente.
  * 
- * \return 1 si une touche est pressée, sinon 0.
+ * \return La touche.
  */
-int kbhit(){
-    int unCaractere=0;
-    struct termios oldt, newt;
-    int ch;
-    int oldf;
-
-    tcgetattr(STDIN_FILENO, &oldt);
-    newt = oldt;
-    newt.c_lflag &= ~(ICANON | ECHO);
-    tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-    oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-    fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
- 
-    ch = getchar();
-
-    tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-    fcntl(STDIN_FILENO, F_SETFL, oldf);
- 
-    if(ch != EOF){
-        ungetc(ch, stdin);
-        unCaractere=1;
-    } 
-    return unCaractere;
+char lireTouche(){
+    return clavier.touches[clavier.debut++];
 }
 
 /**
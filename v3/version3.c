@@ -15,11 +15,12 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
-#include <fcntl.h>
 #include <termios.h>
 #include <string.h>
 #include <stdbool.h>
 #include <time.h>
+#include <poll.h>
+#include <signal.h>
 
 #define MAXTAB_X 80 //constante pour la Taille Max d’un tableau
 #define MAXTAB_Y 40
@@ -36,8 +37,24 @@
 #define DROITE 'd' //constante pour la touche de direction "droite"
 #define BORDURE '#' //constante pour les bordures du plateau de jeu
 #define ESPACE ' ' //constante pour le l'intérieure des bordures du plateau
+#define TAILLE_CLAVIER 64 //constante pour le nombre de touches en attente
+
+/**
+ * \brief État du clavier.
+ *
+ * Le terminal passe une seule fois en mode non canonique sans écho,
+ * les touches lues sont gardées ici jusqu'à leur traitement.
+ */
+typedef struct {
+    struct termios ancien;         // réglages du terminal à restaurer
+    bool actif;                    // le terminal est en mode non canonique
+    char touches[TAILLE_CLAVIER];  // touches lues et pas encore traitées
+    int debut;                     // indice de la prochaine touche à traiter
+    int fin;                       // indice de fin des touches en attente
+} t_clavier;
 
 char plateau[MAXTAB_Y][MAXTAB_X];
+t_clavier clavier;
 
 /**
  * \brief Affiche un caractère à une position donnée.
@@ -72,14 +89,40 @@ void dessinerSerpent(int lesX[], int lesY[], int TailleActuelle);
 void progresser(int lesX[], int lesY[], char direction, bool *Collision);
 
 /**
- * \brief Désactive l'affichage des caractères tapés dans le terminal.
+ * \brief Passe le terminal en mode non canonique sans écho jusqu'à la fin du programme.
+ *
+ * Les réglages d'origine sont restaurés à la sortie du programme
+ * ainsi qu'à la réception d'un signal d'arrêt.
+ */
+void initClavier();
+
+/**
+ * \brief Restaure les réglages d'origine du terminal.
+ */
+void restaurerClavier();
+
+/**
+ * \brief Restaure le terminal puis termine le programme à la réception d'un signal.
+ * \param signal Le signal reçu.
+ */
+void signalArret(int signal);
+
+/**
+ * \brief Indique si une touche est disponible, en attendant au plus le délai donné.
+ *
+ * Si aucune touche n'est en attente, l'entrée est surveillée avec poll()
+ * puis toutes les touches disponibles sont lues en un seul read().
+ *
+ * \param attente Délai maximum en millisecondes (-1 pour attendre sans limite).
+ * \return true si une touche peut être lue avec lireTouche().
  */
-void disableEcho();
+bool toucheDisponible(int attente);
 
 /**
- * \brief Réactive l'affichage des caractères tapés dans le terminal.
+ * \brief Retire la prochaine touche en attente.
+ * \return La touche.
  */
-void enableEcho();
+char lireTouche();
 
 /**
  * \brief Initialise les elements de plateau de jeu donner en paramètres.
@@ -98,8 +141,6 @@ void initPlateau(char plateau[MAXTAB_Y][MAXTAB_X], int lesX[], int lesY[], int T
  */
 void dessinerPlateau(char plateau[MAXTAB_Y][MAXTAB_X]);
 
-int kbhit();
-
 int main()
 {
     int i;
@@ -125,7 +166,7 @@ int main()
 
     TailleActuelle = TAILLE_SERPENT;
 
-    disableEcho();
+    initClavier();
     while (Key != ARRET && Collision == false) {  //Boucle principale 
         for (i = 0; i < TailleActuelle; i++) { //Boucle permettant d'effacer l'ancienne position du serpent
             effacer(lesX[i], lesY[i]);
@@ -134,10 +175,12 @@ int main()
         progresser(lesX, lesY, Key, &Collision);
         dessinerSerpent(lesX, lesY, TailleActuelle);
 
+        fflush(stdout); // Envoyer l'affichage de la trame avant d'attendre
+
         usleep(TEMPORISATION);
 
-        if (kbhit()){ 
-            NewKey = getchar();
+        if (toucheDisponible(0)){ 
+            NewKey = lireTouche();
             if ((NewKey == DROITE && LastKey != GAUCHE) || // Boucle pour empêcher les directions opposées
                 (NewKey == GAUCHE && LastKey != DROITE) ||
                 (NewKey == HAUT && LastKey != BAS) ||
@@ -149,43 +192,12 @@ int main()
         LastKey = Key;
 
     }
-    enableEcho();
+    restaurerClavier();
     system("clear");
     return EXIT_SUCCESS;
 }
 
 
-int kbhit(){
-	// la fonction retourne :
-	// 1 si un caractere est present
-	// 0 si pas de caractere present
-	
-	int unCaractere=0;
-	struct termios oldt, newt;
-	int ch;
-	int oldf;
-
-	// mettre le terminal en mode non bloquant
-	tcgetattr(STDIN_FILENO, &oldt);
-	newt = oldt;
-	newt.c_lflag &= ~(ICANON | ECHO);
-	tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-	oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-	fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
- 
-	ch = getchar();
-
-	// restaurer le mode du terminal
-	tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-	fcntl(STDIN_FILENO, F_SETFL, oldf);
- 
-	if(ch != EOF){
-		ungetc(ch, stdin);
-		unCaractere=1;
-	} 
-	return unCaractere;
-}
-
 void gotoXY(int x, int y) { 
     printf("\033[%d;%df", y, x);
 }
@@ -253,42 +265,86 @@ void effacer(int x, int y)
     printf(" ");
 }
 
-void disableEcho() {
+void initClavier() {
     struct termios tty;
+    struct sigaction action;
 
-    // Obtenir les attributs du terminalchar *plateau[MAXTAB_Y][MAXTAB_X]
-    if (tcgetattr(STDIN_FILENO, &tty) == -1) {
+    // Sauvegarder les attributs du terminal
+    if (tcgetattr(STDIN_FILENO, &clavier.ancien) == -1) {
         perror("tcgetattr");
         exit(EXIT_FAILURE);
     }
 
-    // Desactiver le flag ECHO
-    tty.c_lflag &= ~ECHO;
-
-    // Appliquer les nouvelles configurations
+    // Desactiver le mode canonique et l'écho
+    tty = clavier.ancien;
+    tty.c_lflag &= ~(ICANON | ECHO);
+    tty.c_cc[VMIN] = 1;
+    tty.c_cc[VTIME] = 0;
     if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1) {
         perror("tcsetattr");
         exit(EXIT_FAILURE);
     }
+    clavier.actif = true;
+    clavier.debut = 0;
+    clavier.fin = 0;
+
+    // Restaurer le terminal à la sortie, même interrompue par un signal
+    atexit(restaurerClavier);
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = signalArret;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGHUP, &action, NULL);
+    sigaction(SIGQUIT, &action, NULL);
 }
 
-void enableEcho() {
-    struct termios tty;
-
-    // Obtenir les attributs du terminal
-    if (tcgetattr(STDIN_FILENO, &tty) == -1) {
-        perror("tcgetattr");
-        exit(EXIT_FAILURE);
+void restaurerClavier() {
+    if (clavier.actif) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &clavier.ancien);
+        clavier.actif = false;
     }
+}
 
-    // Reactiver le flag ECHO
-    tty.c_lflag |= ECHO;
+void signalArret(int signal) {
+    struct sigaction action;
 
-    // Appliquer les nouvelles configurations
-    if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1) {
-        perror("tcsetattr");
-        exit(EXIT_FAILURE);
+    restaurerClavier();
+
+    // Terminer le programme avec le comportement par défaut du signal
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_DFL;
+    sigaction(signal, &action, NULL);
+    raise(signal);
+}
+
+bool toucheDisponible(int attente) {
+    struct pollfd entree = { .fd = STDIN_FILENO, .events = POLLIN };
+    ssize_t n;
+
+    if (clavier.debut < clavier.fin) { // Des touches sont déjà en attente
+        return true;
     }
+    clavier.debut = 0;
+    clavier.fin = 0;
+    if (poll(&entree, 1, attente) <= 0) {
+        return false;
+    }
+
+    n = read(STDIN_FILENO, clavier.touches, TAILLE_CLAVIER); // Lire toutes les touches disponibles
+    if (n == 0) { // L'entrée est fermée : on arrête la partie
+        clavier.touches[0] = ARRET;
+        n = 1;
+    }
+    if (n < 0) {
+        return false;
+    }
+    clavier.fin = n;
+    return true;
+}
+
+char lireTouche() {
+    return clavier.touches[clavier.debut++];
 }
 
 void initPlateau(char plateau[MAXTAB_Y][MAXTAB_X], int lesX[], int lesY[], int TailleActuelle) {
@@ -0,0 +1,315 @@
+/**
+* \file affichage.c
+* \brief l'affichage du jeu snake dans le terminal
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <string.h>
+#include <errno.h>
+
+#include "affichage.h"
+#include "trace.h"
+
+#define ECART_MAX 8 //constante pour le nombre de cases identiques renvoyées plutôt que de déplacer le curseur
+
+t_tampon tampon;
+t_modifications modifications;
+t_vue vue;
+
+/**
+ * \brief Donne le caractère à afficher pour une case : tête, anneau ou contenu du plateau.
+ * \param partie La partie.
+ * \param tete Case de la tête du serpent.
+ * \param c Numéro de la case.
+ * \return Le caractère.
+ */
+static char contenuCase(const t_partie *partie, int tete, int c){
+    if (c == tete) {
+        return TETE;
+    }
+    if (estSerpent(&partie->serpent, c)) {
+        return ANNEAUX;
+    }
+    return lireCase(partie, c);
+}
+
+/**
+ * \brief Affiche un caractère à la place d'une case du plateau, si elle est dans la vue.
+ * \param x Position en abscisse de la case dans le plateau.
+ * \param y Position en ordonnée de la case dans le plateau.
+ * \param contenu Caractère à afficher.
+ */
+static void afficherDansVue(int x, int y, char contenu){
+    int colonne = x - vue.origineX;
+    int ligne = y - vue.origineY;
+
+    if (colonne < 0 || colonne >= vue.largeur || ligne < 0 || ligne >= vue.hauteur) {
+        return;
+    }
+    vue.ecran[ligne * vue.largeur + colonne] = contenu;
+    afficher(colonne + 1, ligne + 1, contenu);
+}
+
+/**
+ * \brief Centre la vue sur une case, sans sortir du plateau.
+ * \param partie La partie.
+ * \param x Position en abscisse de la case.
+ * \param y Position en ordonnée de la case.
+ */
+static void centrerVue(const t_partie *partie, int x, int y){
+    vue.origineX = x - vue.largeur / 2;
+    vue.origineY = y - vue.hauteur / 2;
+    if (vue.origineX > partie->config.largeur - vue.largeur) {
+        vue.origineX = partie->config.largeur - vue.largeur;
+    }
+    if (vue.origineY > partie->config.hauteur - vue.hauteur) {
+        vue.origineY = partie->config.hauteur - vue.hauteur;
+    }
+    if (vue.origineX < 0) {
+        vue.origineX = 0;
+    }
+    if (vue.origineY < 0) {
+        vue.origineY = 0;
+    }
+}
+
+void initAffichage(int sortie, const t_partie *partie, int colonnes, int lignes){
+    int tete;
+
+    free(modifications.marquees);
+    free(vue.ecran);
+    free(vue.cible);
+    memset(&tampon, 0, sizeof(tampon));
+    memset(&modifications, 0, sizeof(modifications));
+    memset(&vue, 0, sizeof(vue));
+    tampon.sortie = sortie;
+    modifications.nbMots = (partie->nbCases + 63) / 64;
+    modifications.marquees = calloc(modifications.nbMots, sizeof(uint64_t));
+
+    // La vue prend toute la place disponible, sans dépasser le plateau
+    vue.largeur = (colonnes > 0 && colonnes < partie->config.largeur) ? colonnes : partie->config.largeur;
+    vue.hauteur = (lignes > 0 && lignes < partie->config.hauteur) ? lignes : partie->config.hauteur;
+    vue.ecran = malloc((size_t)vue.largeur * vue.hauteur);
+    vue.cible = malloc((size_t)vue.largeur * vue.hauteur);
+    if (modifications.marquees == NULL || vue.ecran == NULL || vue.cible == NULL) {
+        perror("malloc");
+        exit(EXIT_FAILURE);
+    }
+    memset(vue.ecran, ' ', (size_t)vue.largeur * vue.hauteur); // L'écran vient d'être effacé
+    tete = lireSegment(&partie->serpent, 0);
+    centrerVue(partie, abscisse(partie, tete), ordonnee(partie, tete));
+}
+
+void gotoXY(int x, int y) {
+    char sequence[32];
+
+    tamponAjouter(sequence, snprintf(sequence, sizeof(sequence), "\033[%d;%df", y, x));
+}
+
+void tamponAjouter(const char *octets, int n){
+    if (tampon.longueur + n > TAILLE_TAMPON) { // Plus de place : on vide le tampon avant d'ajouter
+        tamponVider();
+    }
+    memcpy(tampon.octets + tampon.longueur, octets, n);
+    tampon.longueur += n;
+}
+
+void tamponVider(){
+    int ecrits = 0;
+    ssize_t n;
+
+    while (ecrits < tampon.longueur) { // write() peut n'écrire qu'une partie des octets
+        TRACE_DEBUT("write");
+        n = write(tampon.sortie, tampon.octets + ecrits, tampon.longueur - ecrits);
+        TRACE_FIN("write", n);
+        tampon.appelsTrame++;
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("write");
+            exit(EXIT_FAILURE);
+        }
+        ecrits += n;
+    }
+    tampon.octetsTrame += tampon.longueur;
+    tampon.longueur = 0;
+}
+
+void finTrame(){
+    tamponVider();
+    if (tampon.octetsTrame == 0) { // Rien n'a changé : la trame n'est pas comptée
+        return;
+    }
+    tampon.octetsDerniereTrame = tampon.octetsTrame;
+    tampon.appelsDerniereTrame = tampon.appelsTrame;
+    tampon.octetsTotal += tampon.octetsTrame;
+    tampon.appelsTotal += tampon.appelsTrame;
+    tampon.trames++;
+    tampon.octetsTrame = 0;
+    tampon.appelsTrame = 0;
+}
+
+void afficher(int x, int y, char c){
+    gotoXY(x, y);
+    tamponAjouter(&c, 1);
+}
+
+void effacer(int x, int y)
+{
+    gotoXY(x, y);
+    tamponAjouter(" ", 1);
+}
+
+void dessinerPlateau(const t_partie *partie) {
+    int i, j;
+    for (i = vue.origineY; i < vue.origineY + vue.hauteur; i++) {
+        for (j = vue.origineX; j < vue.origineX + vue.largeur; j++) {
+            afficherDansVue(j, i, lireCase(partie, indiceCase(partie, j, i)));
+        }
+    }
+}
+
+void dessinerSerpent(const t_partie *partie){
+    int i, c;
+
+    for (i = 0; i < partie->serpent.taille; i++) { // Affiche la tête puis les anneaux du corps s'ils sont dans la vue
+        c = lireSegment(&partie->serpent, i);
+        afficherDansVue(abscisse(partie, c), ordonnee(partie, c), i == 0 ? TETE : ANNEAUX);
+    }
+}
+
+bool suivreTete(const t_partie *partie){
+    int tete = lireSegment(&partie->serpent, 0);
+    int x = abscisse(partie, tete);
+    int y = ordonnee(partie, tete);
+    int margeX = vue.largeur / 4;
+    int margeY = vue.hauteur / 4;
+    int ancienX = vue.origineX;
+    int ancienY = vue.origineY;
+
+    if (x - vue.origineX < margeX || vue.origineX + vue.largeur - 1 - x < margeX ||
+        y - vue.origineY < margeY || vue.origineY + vue.hauteur - 1 - y < margeY) {
+        centrerVue(partie, x, y); // Au bord du plateau, la vue peut rester en place
+    }
+    if (vue.origineX == ancienX && vue.origineY == ancienY) {
+        return false;
+    }
+    vue.deplacements++;
+    return true;
+}
+
+void dessinerVue(const t_partie *partie){
+    int tete = lireSegment(&partie->serpent, 0);
+    int ligne, k, debut, fin, c;
+    char *ecran, *cible;
+
+    for (ligne = 0; ligne < vue.hauteur; ligne++) {
+        ecran = vue.ecran + ligne * vue.largeur;
+        cible = vue.cible + ligne * vue.largeur;
+        c = indiceCase(partie, vue.origineX, vue.origineY + ligne);
+        for (k = 0; k < vue.largeur; k++, c++) {
+            cible[k] = contenuCase(partie, tete, c);
+        }
+
+        // Envoyer chaque suite de cases différentes, les petits écarts identiques compris
+        k = 0;
+        while (k < vue.largeur) {
+            if (cible[k] == ecran[k]) {
+                k++;
+                continue;
+            }
+            debut = k;
+            fin = k + 1;
+            for (k = fin; k < vue.largeur && k - fin <= ECART_MAX; k++) {
+                if (cible[k] != ecran[k]) {
+                    fin = k + 1;
+                }
+            }
+            gotoXY(debut + 1, ligne + 1);
+            tamponAjouter(cible + debut, fin - debut);
+            k = fin;
+        }
+    }
+    // La cible devient ce qui est affiché
+    ecran = vue.ecran;
+    vue.ecran = vue.cible;
+    vue.cible = ecran;
+}
+
+void marquerCase(int c){
+    if (modifications.complet || (modifications.marquees[c / 64] >> (c % 64)) & 1) { // Déjà retenue
+        return;
+    }
+    if (modifications.nombre == MAX_MODIFICATIONS) { // Trop de cases : la prochaine trame redessine tout
+        modifications.complet = true;
+        return;
+    }
+    modifications.marquees[c / 64] |= (uint64_t)1 << (c % 64);
+    modifications.lesCases[modifications.nombre] = c;
+    modifications.nombre++;
+}
+
+void marquerProgression(const t_partie *partie, int ancienneTete, const t_resultat *resultat){
+    if (resultat->pomme == false) { // La case quittée par la queue
+        marquerCase(resultat->queue);
+    }
+    else if (resultat->gagne == false) { // La nouvelle pomme
+        marquerCase(partie->pomme);
+    }
+    marquerCase(ancienneTete); // L'ancienne tête devient un anneau
+    marquerCase(lireSegment(&partie->serpent, 0));
+}
+
+void dessinerCase(const t_partie *partie, int c){
+    afficherDansVue(abscisse(partie, c), ordonnee(partie, c), contenuCase(partie, lireSegment(&partie->serpent, 0), c));
+}
+
+void dessinerDelta(const t_partie *partie){
+    int i;
+
+    if (modifications.complet) {
+        dessinerVue(partie);
+        memset(modifications.marquees, 0, modifications.nbMots * sizeof(uint64_t));
+    }
+    else {
+        for (i = 0; i < modifications.nombre; i++) {
+            dessinerCase(partie, modifications.lesCases[i]);
+            // Effacer les marques du mot de la case : toutes appartiennent à des cases de la liste
+            modifications.marquees[modifications.lesCases[i] / 64] = 0;
+        }
+    }
+    modifications.nombre = 0;
+    modifications.complet = false;
+}
+
+void dessinerCompteur(const t_partie *partie){
+    char texte[32];
+
+    gotoXY(vue.largeur + 10, vue.hauteur / 2);
+    tamponAjouter(texte, snprintf(texte, sizeof(texte), "Pomme mangées: %d", partie->pommeMange));
+}
+
+void dessinerMemoire(const t_partie *partie){
+    char texte[48];
+
+    gotoXY(vue.largeur + 10, vue.hauteur / 2 + 1);
+    tamponAjouter(texte, snprintf(texte, sizeof(texte), "Mémoire: %.1f Mo", partie->memoire / 1048576.0));
+}
+
+void dessinerTrame(const t_partie *partie, int *pommeAffichee){
+    if (suivreTete(partie)) { // La vue a bougé : elle est comparée en entier à l'écran
+        modifications.complet = true;
+    }
+    dessinerDelta(partie); // Sinon seules les cases modifiées sont redessinées
+    if (partie->pommeMange != *pommeAffichee) {
+        dessinerCompteur(partie);
+        *pommeAffichee = partie->pommeMange;
+    }
+    finTrame(); // Toute la trame part en un seul appel à write()
+}
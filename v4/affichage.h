@@ -0,0 +1,227 @@
+/**
+* \file affichage.h
+* \brief l'affichage du jeu snake dans le terminal
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Les trames sont construites dans un tampon puis envoyées au terminal
+* par un seul appel à write(). Entre deux trames, seules les cases
+* modifiées par la simulation sont redessinées.
+*
+* Seule une fenêtre du plateau, la vue, est affichée. Elle suit la tête
+* du serpent et garde une copie de ce qui est à l'écran : quand elle se
+* déplace, seules les différences sont envoyées, ligne par ligne.
+*
+*/
+#ifndef AFFICHAGE_H
+#define AFFICHAGE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "moteur.h"
+
+#define TETE 'O' //constante pour la tete du serpent
+#define ANNEAUX 'X' //constante pour les anneaux du serpent
+#define TAILLE_TAMPON 65536 //constante pour la taille du tampon d'affichage
+#define MAX_MODIFICATIONS 1024 //constante pour le nombre de cases modifiées retenues entre deux trames
+#define LARGEUR_COMPTEUR 32 //constante pour la place laissée au compteur à droite de la vue
+
+/**
+ * \brief Tampon d'affichage d'une trame.
+ *
+ * Les séquences d'échappement et les caractères d'une trame y sont
+ * accumulés puis envoyés au terminal par un seul appel à write().
+ */
+typedef struct {
+    char octets[TAILLE_TAMPON]; // octets en attente d'écriture
+    int longueur;               // nombre d'octets en attente
+    int sortie;                 // descripteur de fichier où les trames sont écrites
+    long octetsTrame;           // octets écrits pendant la trame en cours
+    int appelsTrame;            // appels à write() pendant la trame en cours
+    long octetsDerniereTrame;   // octets écrits pendant la dernière trame
+    int appelsDerniereTrame;    // appels à write() pendant la dernière trame
+    long octetsTotal;           // octets écrits depuis le début de la partie
+    long appelsTotal;           // appels à write() depuis le début de la partie
+    long trames;                // nombre de trames terminées
+} t_tampon;
+
+/**
+ * \brief Cases modifiées par la simulation depuis la dernière trame.
+ *
+ * Plusieurs ticks peuvent s'écouler entre deux trames, leurs modifications
+ * sont regroupées ici et chaque case n'est redessinée qu'une fois.
+ */
+typedef struct {
+    int lesCases[MAX_MODIFICATIONS]; // cases modifiées
+    int nombre;                      // nombre de cases modifiées
+    bool complet;                    // trop de modifications : tout le plateau est redessiné
+    uint64_t *marquees;              // un bit par case déjà retenue
+    int nbMots;                      // nombre de mots de marquees
+} t_modifications;
+
+/**
+ * \brief Fenêtre du plateau affichée dans le terminal.
+ *
+ * La case (x, y) du plateau est affichée à la position
+ * (x - origineX + 1, y - origineY + 1) du terminal.
+ */
+typedef struct {
+    int origineX;      // position en abscisse de la case affichée en haut à gauche
+    int origineY;      // position en ordonnée de la case affichée en haut à gauche
+    int largeur;       // nombre de colonnes de cases affichées
+    int hauteur;       // nombre de lignes de cases affichées
+    char *ecran;       // caractère actuellement affiché pour chaque case de la vue, ligne par ligne
+    char *cible;       // caractères à afficher après un déplacement de la vue
+    long deplacements; // nombre de déplacements de la vue
+} t_vue;
+
+extern t_tampon tampon;
+extern t_modifications modifications;
+extern t_vue vue;
+
+/**
+ * \brief Prépare le tampon d'affichage et la vue, et remet leurs compteurs à zéro.
+ *
+ * L'écran est supposé effacé. La vue est centrée sur la tête du serpent.
+ *
+ * \param sortie Descripteur de fichier où les trames sont écrites.
+ * \param partie La partie affichée, qui donne la taille du plateau.
+ * \param colonnes Nombre de colonnes disponibles pour la vue, 0 pour tout le plateau.
+ * \param lignes Nombre de lignes disponibles pour la vue, 0 pour tout le plateau.
+ */
+void initAffichage(int sortie, const t_partie *partie, int colonnes, int lignes);
+
+/**
+ * \brief Place le curseur à une position donnée.
+ * \param x Position en abscisse.
+ * \param y Position en ordonnée.
+ */
+void gotoXY(int x, int y);
+
+/**
+ * \brief Ajoute des octets au tampon d'affichage.
+ *
+ * Le tampon est vidé avant l'ajout s'il n'a plus assez de place.
+ *
+ * \param octets Les octets à ajouter.
+ * \param n Nombre d'octets.
+ */
+void tamponAjouter(const char *octets, int n);
+
+/**
+ * \brief Écrit les octets en attente du tampon d'affichage.
+ */
+void tamponVider();
+
+/**
+ * \brief Termine la trame en cours : vide le tampon et met à jour les compteurs.
+ */
+void finTrame();
+
+/**
+ * \brief Affiche un caractère à une position donnée.
+ * \param x Position en abscisse.
+ * \param y Position en ordonnée.
+ * \param c Caractère à afficher.
+ */
+void afficher(int x, int y, char c);
+
+/**
+ * \brief Efface le caractère à une position donnée.
+ * \param x Position en abscisse.
+ * \param y Position en ordonnée.
+ */
+void effacer(int x, int y);
+
+/**
+ * \brief Affiche les elements de plateau de jeu visibles dans la vue.
+ *
+ * \param partie La partie
+ */
+void dessinerPlateau(const t_partie *partie);
+
+/**
+ * \brief Dessine les segments du serpent visibles dans la vue.
+ * \param partie La partie dont le serpent est dessiné.
+ */
+void dessinerSerpent(const t_partie *partie);
+
+/**
+ * \brief Déplace la vue si la tête du serpent s'approche de son bord.
+ *
+ * La vue est alors recentrée sur la tête, sans sortir du plateau.
+ * Elle ne bouge pas si le plateau entier est visible.
+ *
+ * \param partie La partie.
+ * \return true si la vue a bougé et doit être redessinée avec dessinerVue().
+ */
+bool suivreTete(const t_partie *partie);
+
+/**
+ * \brief Redessine la vue en n'envoyant que les cases qui diffèrent de l'écran.
+ *
+ * Chaque ligne de la vue est comparée à ce qui est affiché, les suites
+ * de cases différentes sont envoyées avec un seul déplacement du curseur.
+ * Le coût dépend de la taille de la vue, pas de celle du plateau.
+ *
+ * \param partie La partie.
+ */
+void dessinerVue(const t_partie *partie);
+
+/**
+ * \brief Retient qu'une case doit être redessinée à la prochaine trame.
+ * \param c Numéro de la case.
+ */
+void marquerCase(int c);
+
+/**
+ * \brief Retient les cases modifiées par un tick.
+ *
+ * La nouvelle tête, l'ancienne tête devenue anneau, la case libérée
+ * par la queue et la nouvelle pomme sont marquées.
+ *
+ * \param partie La partie après le tick.
+ * \param ancienneTete Case de la tête avant le tick.
+ * \param resultat Le résultat du tick.
+ */
+void marquerProgression(const t_partie *partie, int ancienneTete, const t_resultat *resultat);
+
+/**
+ * \brief Dessine une case selon son état actuel : tête, anneau ou contenu du plateau.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ */
+void dessinerCase(const t_partie *partie, int c);
+
+/**
+ * \brief Redessine uniquement les cases modifiées depuis la dernière trame.
+ *
+ * Les cases marquées pendant tous les ticks écoulés forment un seul delta.
+ * S'il y en a trop, la vue est redessinée avec dessinerVue().
+ *
+ * \param partie La partie.
+ */
+void dessinerDelta(const t_partie *partie);
+
+/**
+ * \brief Affiche le nombre de pommes mangées à droite de la vue.
+ * \param partie La partie.
+ */
+void dessinerCompteur(const t_partie *partie);
+
+/**
+ * \brief Affiche la mémoire occupée par la partie, sous le compteur de pommes.
+ * \param partie La partie.
+ */
+void dessinerMemoire(const t_partie *partie);
+
+/**
+ * \brief Construit et envoie une trame : vue déplacée ou cases modifiées, et compteur s'il a changé.
+ * \param partie La partie.
+ * \param pommeAffichee Valeur actuellement affichée du compteur.
+ */
+void dessinerTrame(const t_partie *partie, int *pommeAffichee);
+
+#endif
@@ -0,0 +1,44 @@
+/**
+* \file alea.c
+* \brief le générateur pseudo-aléatoire du jeu snake
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+*/
+#include "alea.h"
+
+#define MULTIPLICATEUR 6364136223846793005ULL //constante du générateur congruentiel de PCG32
+
+void initAlea(t_alea *alea, uint64_t graine, uint64_t flux){
+    alea->etat = 0;
+    alea->increment = (flux << 1) | 1; // L'incrément doit être impair
+    aleaSuivant(alea);
+    alea->etat += graine;
+    aleaSuivant(alea);
+}
+
+uint32_t aleaSuivant(t_alea *alea){
+    uint64_t ancien = alea->etat;
+    uint32_t melange, rotation;
+
+    alea->etat = ancien * MULTIPLICATEUR + alea->increment;
+    melange = (uint32_t)(((ancien >> 18) ^ ancien) >> 27);
+    rotation = (uint32_t)(ancien >> 59);
+    return (melange >> rotation) | (melange << ((-rotation) & 31));
+}
+
+uint32_t aleaBorne(t_alea *alea, uint32_t borne){
+    uint64_t produit = (uint64_t)aleaSuivant(alea) * borne;
+    uint32_t bas = (uint32_t)produit;
+    uint32_t seuil;
+
+    if (bas < borne) { // Le tirage peut tomber dans la zone qui biaiserait le résultat
+        seuil = -borne % borne; // 2^32 modulo borne
+        while (bas < seuil) {
+            produit = (uint64_t)aleaSuivant(alea) * borne;
+            bas = (uint32_t)produit;
+        }
+    }
+    return (uint32_t)(produit >> 32);
+}
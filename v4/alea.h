@@ -0,0 +1,59 @@
+/**
+* \file alea.h
+* \brief le générateur pseudo-aléatoire du jeu snake
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Générateur PCG32 (XSH RR) : 64 bits d'état, sorties de 32 bits.
+* Chaque partie possède son propre générateur, sans état global caché.
+* La graine choisit le point de départ et le flux choisit une suite
+* indépendante : deux parties de même graine et de flux différents
+* ne partagent aucun tirage.
+*
+*/
+#ifndef ALEA_H
+#define ALEA_H
+
+#include <stdint.h>
+
+/**
+ * \brief État d'un générateur pseudo-aléatoire.
+ */
+typedef struct {
+    uint64_t etat;      // état courant, avance à chaque tirage
+    uint64_t increment; // impair, choisit le flux
+} t_alea;
+
+/**
+ * \brief Initialise un générateur.
+ *
+ * Deux générateurs initialisés avec la même graine et le même flux
+ * produisent la même suite de tirages.
+ *
+ * \param alea Le générateur.
+ * \param graine Graine du générateur.
+ * \param flux Numéro du flux.
+ */
+void initAlea(t_alea *alea, uint64_t graine, uint64_t flux);
+
+/**
+ * \brief Tire un entier de 32 bits.
+ * \param alea Le générateur.
+ * \return Un entier uniforme entre 0 et 2^32 - 1.
+ */
+uint32_t aleaSuivant(t_alea *alea);
+
+/**
+ * \brief Tire un entier entre 0 et borne - 1 sans biais.
+ *
+ * Méthode de Lemire : une multiplication 32 x 64 bits, et une division
+ * seulement dans les rares cas où le tirage doit être refait.
+ *
+ * \param alea Le générateur.
+ * \param borne Nombre de valeurs possibles, au moins 1.
+ * \return Un entier uniforme entre 0 et borne - 1.
+ */
+uint32_t aleaBorne(t_alea *alea, uint32_t borne);
+
+#endif
@@ -0,0 +1,157 @@
+/**
+* \file autopilote.c
+* \brief le pilote automatique du serpent
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "autopilote.h"
+
+/**
+ * \brief Arrondit une taille au multiple de LIGNE_CACHE supérieur.
+ * \param taille La taille.
+ * \return La taille arrondie.
+ */
+static size_t arrondirLigne(size_t taille){
+    return (taille + LIGNE_CACHE - 1) / LIGNE_CACHE * LIGNE_CACHE;
+}
+
+/**
+ * \brief Donne la date actuelle de l'horloge monotone.
+ * \return La date en nanosecondes.
+ */
+static int64_t dateActuelle(){
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+/**
+ * \brief Commence un nouveau parcours : les marques des parcours précédents ne comptent plus.
+ * \param pilote Le pilote.
+ */
+static void nouvelleGeneration(t_autopilote *pilote){
+    pilote->generation++;
+    if (pilote->generation == 0) { // Après 2^32 parcours, les anciennes marques pourraient revenir
+        memset(pilote->marques, 0, pilote->nbCases * sizeof(uint32_t));
+        pilote->generation = 1;
+    }
+}
+
+/**
+ * \brief Remonte le chemin trouvé jusqu'à la tête.
+ * \param pilote Le pilote, après le parcours.
+ * \param tete Case de la tête.
+ * \param cible Case atteinte par le parcours.
+ * \return Indice de la direction du premier pas.
+ */
+static int premierPas(const t_autopilote *pilote, int tete, int cible){
+    while (pilote->parents[cible] != tete) {
+        cible = pilote->parents[cible];
+    }
+    return pilote->pas[cible];
+}
+
+t_autopilote *autopiloteCreer(const t_partie *partie){
+    t_autopilote *pilote;
+    size_t tailleFile = arrondirLigne(partie->nbCases * sizeof(int));
+    size_t tailleMarques = arrondirLigne(partie->nbCases * sizeof(uint32_t));
+    char *zone;
+
+    pilote = calloc(1, sizeof(t_autopilote));
+    if (pilote == NULL) {
+        return NULL;
+    }
+    zone = aligned_alloc(LIGNE_CACHE, 2 * tailleFile + tailleMarques + arrondirLigne(partie->nbCases));
+    if (zone == NULL) {
+        free(pilote);
+        return NULL;
+    }
+    pilote->zone = zone;
+    pilote->nbCases = partie->nbCases;
+    pilote->file = (int *)zone;
+    pilote->parents = (int *)(zone + tailleFile);
+    pilote->marques = (uint32_t *)(zone + 2 * tailleFile);
+    pilote->pas = (unsigned char *)(zone + 2 * tailleFile + tailleMarques);
+    memset(pilote->marques, 0, pilote->nbCases * sizeof(uint32_t)); // Seule remise à zéro avant le premier parcours
+    return pilote;
+}
+
+void autopiloteDetruire(t_autopilote *pilote){
+    free(pilote->zone);
+    free(pilote);
+}
+
+char choisirChemin(t_autopilote *pilote, const t_partie *partie){
+    int64_t debut = dateActuelle();
+    int tete = lireSegment(&partie->serpent, 0);
+    int queue = lireSegment(&partie->serpent, partie->serpent.taille - 1);
+    int actuelle = indiceDirection(partie->direction);
+    int lecture = 0, ecriture = 0;
+    int cible = -1;
+    int c, d, n;
+    char choix = partie->direction;
+
+    nouvelleGeneration(pilote);
+    pilote->marques[tete] = pilote->generation;
+    pilote->file[ecriture++] = tete;
+    while (lecture < ecriture && cible < 0) { // Parcours en largeur jusqu'à la pomme
+        c = pilote->file[lecture++];
+        for (d = 0; d < NB_DIRECTIONS; d++) {
+            if ((c == tete && d == (actuelle ^ 1)) || estMur(partie, c + partie->decalages[d])) {
+                continue; // Le moteur ignore le demi-tour, le mur se voit dans la case voisine
+            }
+            n = caseSuivante(partie, c, d);
+            if (pilote->marques[n] == pilote->generation) {
+                continue;
+            }
+            // La queue n'a libéré sa case qu'à partir du deuxième pas
+            if (estSerpent(&partie->serpent, n) && (n != queue || c == tete)) {
+                continue;
+            }
+            pilote->marques[n] = pilote->generation;
+            pilote->parents[n] = c;
+            pilote->pas[n] = (unsigned char)d;
+            pilote->file[ecriture++] = n;
+            if (n == partie->pomme && estPomme(partie, n)) {
+                cible = n;
+                break;
+            }
+        }
+    }
+
+    if (cible >= 0) {
+        pilote->versPomme++;
+    }
+    else if (queue != tete && pilote->marques[queue] == pilote->generation) { // Tout a été parcouru sans trouver la pomme
+        cible = queue;
+        pilote->versQueue++;
+    }
+    if (cible >= 0) {
+        choix = lesDirections[premierPas(pilote, tete, cible)];
+    }
+    else {
+        pilote->secours++;
+        for (d = 0; d < NB_DIRECTIONS; d++) { // Une case voisine atteinte par le parcours
+            n = caseSuivante(partie, tete, d);
+            if (pilote->marques[n] == pilote->generation && n != tete && pilote->parents[n] == tete) {
+                choix = lesDirections[pilote->pas[n]];
+                break;
+            }
+        }
+    }
+
+    pilote->derniereDuree = dateActuelle() - debut;
+    pilote->dureeTotale += pilote->derniereDuree;
+    if (pilote->derniereDuree > pilote->dureeMax) {
+        pilote->dureeMax = pilote->derniereDuree;
+    }
+    pilote->decisions++;
+    return choix;
+}
@@ -0,0 +1,75 @@
+/**
+* \file autopilote.h
+* \brief le pilote automatique du serpent
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* À chaque tick, un parcours en largeur part de la tête et suit la table
+* des cases suivantes de la partie, passages par la bordure compris.
+* Les bordures, les pavés et le corps du serpent bloquent le parcours,
+* sauf la queue qui libère sa case pendant le tick. Le pilote prend le
+* plus court chemin vers la pomme ; sans chemin, il suit sa queue pour
+* gagner du temps ; sans chemin vers la queue, il prend une case voisine
+* libre, ou continue tout droit.
+*
+* Les tableaux du parcours sont alloués une fois pour toutes à la création.
+* Une case est visitée si sa marque vaut la génération du parcours en cours :
+* un nouveau parcours n'efface rien, il change de génération.
+*
+* La durée de chaque décision est mesurée et cumulée dans le pilote.
+*
+*/
+#ifndef AUTOPILOTE_H
+#define AUTOPILOTE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "moteur.h"
+
+/**
+ * \brief Tableaux du parcours et mesures des décisions.
+ *
+ * Les tableaux ont une entrée par case du plateau, sentinelles comprises,
+ * et sont pris dans une seule zone mémoire alignée sur LIGNE_CACHE octets.
+ */
+typedef struct {
+    int *file;              // cases atteintes, dans l'ordre du parcours
+    int *parents;           // case d'où le parcours a atteint chaque case
+    uint32_t *marques;      // génération du dernier parcours qui a atteint chaque case
+    unsigned char *pas;     // direction prise depuis le parent pour atteindre chaque case
+    uint32_t generation;    // génération du parcours en cours
+    int nbCases;            // nombre de cases du plateau
+    void *zone;             // zone mémoire qui contient tous les tableaux
+    long decisions;         // nombre de directions choisies
+    long versPomme;         // décisions qui suivent un chemin vers la pomme
+    long versQueue;         // décisions qui suivent un chemin vers la queue
+    long secours;           // décisions sans chemin, case voisine libre ou tout droit
+    int64_t dureeTotale;    // somme des durées des décisions, en nanosecondes
+    int64_t dureeMax;       // plus longue décision, en nanosecondes
+    int64_t derniereDuree;  // durée de la dernière décision, en nanosecondes
+} t_autopilote;
+
+/**
+ * \brief Crée un pilote pour les parties dont le plateau a la taille de celui-ci.
+ * \param partie Une partie, qui donne le nombre de cases.
+ * \return Le pilote, ou NULL si la mémoire manque.
+ */
+t_autopilote *autopiloteCreer(const t_partie *partie);
+
+/**
+ * \brief Libère un pilote créé par autopiloteCreer().
+ * \param pilote Le pilote.
+ */
+void autopiloteDetruire(t_autopilote *pilote);
+
+/**
+ * \brief Choisit la direction du prochain tick, sans allocation ni remise à zéro des tableaux.
+ * \param pilote Le pilote.
+ * \param partie La partie, de la taille donnée à la création du pilote.
+ * \return La direction à passer à avancerPartie().
+ */
+char choisirChemin(t_autopilote *pilote, const t_partie *partie);
+
+#endif
@@ -0,0 +1,826 @@
+/**
+* \file bench.c
+* \brief mesures de performance des fonctions du jeu snake
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Chaque cas répète une opération par lots, mesure la durée de chaque lot
+* et affiche le temps par opération (médiane, 90e et 99e centiles, moyenne)
+* ainsi que le nombre d'allocations mémoire par opération.
+* Les médianes peuvent être enregistrées dans un fichier de référence puis
+* comparées lors d'une exécution suivante pour repérer les régressions.
+*
+* Avec --journal, une partie enregistrée par version4 est rejouée en boucle
+* pour mesurer le moteur et l'affichage sur une partie réelle.
+*
+* Compilation : gcc -O2 -o bench bench.c moteur.c affichage.c alea.c journal.c environnement.c
+* Utilisation : ./bench [--enregistrer fichier] [--comparer fichier] [--journal journal]
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include <limits.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "moteur.h"
+#include "affichage.h"
+#include "journal.h"
+#include "environnement.h"
+
+#define NB_LOTS 1000 //constante pour le nombre de lots mesurés par cas
+#define MAX_CAS 64 //constante pour le nombre maximum de cas
+#define LARGEUR_CYCLE (MAXTAB_X - 2) //constante pour la largeur de l'intérieur du plateau
+#define HAUTEUR_CYCLE (MAXTAB_Y - 2) //constante pour la hauteur de l'intérieur du plateau
+#define LONGUEUR_CYCLE (LARGEUR_CYCLE * HAUTEUR_CYCLE) //constante pour le nombre de cases du cycle
+#define GRAND_PLATEAU 4096 //constante pour le côté du plateau des mesures sur un grand plateau
+#define PLATEAU_MOYEN 1024 //constante pour le côté du plateau des mesures de indexerCasesLibres()
+#define LARGEUR_VUE 120 //constante pour la largeur de la vue des mesures de déplacement de la vue
+#define HAUTEUR_VUE 40 //constante pour la hauteur de la vue des mesures de déplacement de la vue
+#define NB_ENVIRONNEMENTS 16 //constante pour le nombre d'environnements avancés ensemble
+
+/**
+ * \brief Un cas de mesure : une opération répétée et sa préparation.
+ */
+typedef struct {
+    char nom[48];                      // nom affiché et enregistré
+    void (*preparer)(int parametre);   // met en place l'état avant les mesures
+    void (*operation)();               // l'opération mesurée
+    int parametre;                     // paramètre passé à la préparation
+    int parLot;                        // nombre d'opérations par lot
+} t_cas;
+
+/**
+ * \brief Résultat des mesures d'un cas, en nanosecondes par opération.
+ */
+typedef struct {
+    double mediane;
+    double centile90;
+    double centile99;
+    double moyenne;
+    double allocations; // allocations mémoire par opération
+} t_mesure;
+
+t_partie *partie;
+int cycleX[LONGUEUR_CYCLE];     // cases d'un cycle qui passe par tout l'intérieur du plateau
+int cycleY[LONGUEUR_CYCLE];
+int cycleCase[LONGUEUR_CYCLE];  // numéros des cases du cycle dans la partie
+char cycleDirection[LONGUEUR_CYCLE]; // direction pour aller de chaque case du cycle à la suivante
+int position;                   // rang dans le cycle de la tête du serpent
+int sensVue = 1;                // sens du déplacement de la vue d'une mesure à l'autre
+int refX[LONGUEUR_CYCLE];       // serpent de la version 3, décalé à chaque progression
+int refY[LONGUEUR_CYCLE];
+int refTaille;
+long allocations;               // nombre d'appels aux fonctions d'allocation
+t_lecteur lecteur;              // partie rejouée par les cas de rejeu
+long tick;                      // tick de la partie rejouée
+char cleRejouee;                // direction demandée dans la partie rejouée
+t_environnement lesEnvironnements[NB_ENVIRONNEMENTS]; // environnements des cas d'entraînement
+uint8_t *lesPlans;              // plans d'observation des environnements
+t_alea aleaActions;             // actions au hasard des environnements
+
+/**
+ * \brief Compte les allocations mémoire avant de les confier à la glibc.
+ */
+extern void *__libc_malloc(size_t taille);
+extern void *__libc_calloc(size_t nombre, size_t taille);
+extern void *__libc_realloc(void *bloc, size_t taille);
+extern void *__libc_memalign(size_t alignement, size_t taille);
+
+void *malloc(size_t taille){
+    allocations++;
+    return __libc_malloc(taille);
+}
+
+void *calloc(size_t nombre, size_t taille){
+    allocations++;
+    return __libc_calloc(nombre, taille);
+}
+
+void *realloc(void *bloc, size_t taille){
+    allocations++;
+    return __libc_realloc(bloc, taille);
+}
+
+void *aligned_alloc(size_t alignement, size_t taille){
+    allocations++;
+    return __libc_memalign(alignement, taille);
+}
+
+void *memalign(size_t alignement, size_t taille){
+    allocations++;
+    return __libc_memalign(alignement, taille);
+}
+
+int posix_memalign(void **bloc, size_t alignement, size_t taille){
+    void *alloue;
+
+    // L'alignement doit être une puissance de deux multiple de la taille d'un pointeur
+    if (alignement % sizeof(void *) != 0 || (alignement & (alignement - 1)) != 0) {
+        return EINVAL;
+    }
+    allocations++;
+    alloue = __libc_memalign(alignement, taille);
+    if (alloue == NULL) {
+        return ENOMEM;
+    }
+    *bloc = alloue;
+    return 0;
+}
+
+/**
+ * \brief Donne la date actuelle de l'horloge monotone.
+ * \return La date en nanosecondes.
+ */
+int64_t maintenant();
+
+/**
+ * \brief Remplace la partie mesurée par une nouvelle partie.
+ * \param config Réglages de la partie.
+ * \param graine Graine du générateur pseudo-aléatoire.
+ */
+void nouvellePartie(const t_config *config, uint64_t graine);
+
+/**
+ * \brief Construit un cycle qui passe une fois par chaque case de l'intérieur du plateau.
+ *
+ * Le cycle parcourt les lignes en serpentin à partir de la deuxième colonne
+ * et revient au départ par la première colonne.
+ */
+void construireCycle();
+
+/**
+ * \brief Prépare un plateau sans pavé ni pomme avec un serpent posé sur le cycle.
+ * \param longueur Longueur du serpent.
+ */
+void preparerSerpent(int longueur);
+
+/**
+ * \brief Fait progresser le serpent d'une case le long du cycle.
+ */
+void operationProgresser();
+
+/**
+ * \brief Prépare NB_ENVIRONNEMENTS environnements aux réglages d'origine.
+ */
+void preparerEnvironnements(int parametre);
+
+/**
+ * \brief Joue une action au hasard dans chacun des NB_ENVIRONNEMENTS environnements.
+ */
+void operationAvancerEnvironnements();
+
+/**
+ * \brief Prépare un plateau carré sans pomme, le serpent au départ.
+ * \param cote Côté du plateau.
+ * \param nbPaves Nombre de pavés.
+ * \param stockage STOCKAGE_OCTETS ou STOCKAGE_BITS.
+ */
+void preparerPlateauCarre(int cote, int nbPaves, int stockage);
+
+/**
+ * \brief Prépare un plateau de GRAND_PLATEAU cases de côté sans pavé.
+ * \param stockage STOCKAGE_OCTETS ou STOCKAGE_BITS.
+ */
+void preparerGrandPlateau(int stockage);
+
+/**
+ * \brief Prépare un plateau de PLATEAU_MOYEN cases de côté avec des pavés.
+ * \param stockage STOCKAGE_OCTETS ou STOCKAGE_BITS.
+ */
+void preparerPlateauMoyen(int stockage);
+
+/**
+ * \brief Reconstruit l'ensemble des cases libres.
+ */
+void operationIndexer();
+
+/**
+ * \brief Fait progresser le serpent d'une case vers la droite.
+ *
+ * Le serpent parcourt la ligne du milieu et passe d'un bord à l'autre
+ * par les ouvertures de la bordure.
+ */
+void operationProgresserDroite();
+
+/**
+ * \brief Prépare le serpent de la version 3 posé sur le cycle.
+ * \param longueur Longueur du serpent.
+ */
+void preparerReference(int longueur);
+
+/**
+ * \brief Progression de la version 3 : recherche de collision et décalage de tout le corps.
+ */
+void operationReference();
+
+/**
+ * \brief Place puis retire une pomme.
+ */
+void operationAjouterPomme();
+
+/**
+ * \brief Tire une case au hasard parmi toutes celles du plateau.
+ */
+void operationAleaBorne();
+
+/**
+ * \brief Prépare une partie au départ.
+ * \param parametre Inutilisé.
+ */
+void preparerPartie(int parametre);
+
+/**
+ * \brief Prépare une partie avec de nombreux petits pavés.
+ * \param nombre Nombre de pavés de côté 2.
+ */
+void preparerPaves(int nombre);
+
+/**
+ * \brief Initialise le plateau et place les pavés.
+ */
+void operationInitPlateau();
+
+/**
+ * \brief Ouvre /dev/null pour y envoyer les trames, à la place de la sortie précédente.
+ * \return Le descripteur de fichier.
+ */
+int ouvrirSortieNulle();
+
+/**
+ * \brief Prépare l'affichage vers /dev/null et une partie qui avance le long du cycle.
+ * \param longueur Longueur du serpent.
+ */
+void preparerAffichage(int longueur);
+
+/**
+ * \brief Prépare une vue de LARGEUR_VUE x HAUTEUR_VUE cases sur un plateau carré couvert de pavés.
+ * \param cote Côté du plateau.
+ */
+void preparerVue(int cote);
+
+/**
+ * \brief Décale la vue d'une colonne et envoie les différences avec l'écran.
+ */
+void operationDeplacerVue();
+
+/**
+ * \brief Avance d'un tick et envoie la trame des cases modifiées.
+ */
+void operationTrameDelta();
+
+/**
+ * \brief Redessine et envoie le plateau et le serpent entiers.
+ */
+void operationTrameComplete();
+
+/**
+ * \brief Prépare l'affichage vers /dev/null et le début de la partie rejouée.
+ * \param parametre Inutilisé.
+ */
+void preparerRejeu(int parametre);
+
+/**
+ * \brief Recommence la partie rejouée depuis son premier tick.
+ */
+void recommencerRejeu();
+
+/**
+ * \brief Avance la partie rejouée d'un tick, et la recommence quand elle se termine.
+ * \return Le résultat du tick.
+ */
+t_resultat tickRejoue();
+
+/**
+ * \brief Avance la partie rejouée d'un tick.
+ */
+void operationRejeuMoteur();
+
+/**
+ * \brief Avance la partie rejouée d'un tick et envoie la trame des cases modifiées.
+ */
+void operationRejeuTrame();
+
+/**
+ * \brief Mesure un cas.
+ * \param cas Le cas.
+ * \return Les mesures.
+ */
+t_mesure mesurer(const t_cas *cas);
+
+/**
+ * \brief Compare deux durées pour qsort().
+ */
+int comparerDurees(const void *a, const void *b);
+
+int main(int argc, char *argv[])
+{
+    t_cas lesCas[MAX_CAS];
+    t_mesure lesMesures[MAX_CAS];
+    int nbCas = 0;
+    int i;
+    const int longueurs[] = { 10, 100, 1000, LONGUEUR_CYCLE - 1 };
+    const int remplissages[] = { 0, 50, 90, 99 };
+    const int stockages[] = { STOCKAGE_OCTETS, STOCKAGE_BITS };
+    const char *suffixes[] = { "", ",bits" };
+    const char *enregistrer = NULL;
+    const char *comparer = NULL;
+    const char *journal = NULL;
+    FILE *fichier;
+    char nom[48];
+    double mediane;
+
+    for (i = 1; i < argc; i++) { // Lecture des options
+        if (strcmp(argv[i], "--enregistrer") == 0 && i + 1 < argc) {
+            enregistrer = argv[++i];
+        }
+        else if (strcmp(argv[i], "--comparer") == 0 && i + 1 < argc) {
+            comparer = argv[++i];
+        }
+        else if (strcmp(argv[i], "--journal") == 0 && i + 1 < argc) {
+            journal = argv[++i];
+        }
+        else {
+            fprintf(stderr, "usage : %s [--enregistrer fichier] [--comparer fichier] [--journal journal]\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    construireCycle();
+
+    for (i = 0; i < 4; i++) { // progresser() selon la longueur du serpent
+        lesCas[nbCas] = (t_cas){ .preparer = preparerSerpent, .operation = operationProgresser,
+                                 .parametre = longueurs[i], .parLot = 256 };
+        snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "progresser/longueur=%d", longueurs[i]);
+        nbCas++;
+    }
+    for (i = 0; i < 2; i++) { // Grand plateau, un octet par case puis en plans de bits
+        lesCas[nbCas] = (t_cas){ .preparer = preparerGrandPlateau, .operation = operationProgresserDroite,
+                                 .parametre = stockages[i], .parLot = 256 };
+        snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "progresser/plateau=%dx%d%s",
+                 GRAND_PLATEAU, GRAND_PLATEAU, suffixes[i]);
+        nbCas++;
+    }
+    for (i = 0; i < 4; i++) { // Même chose avec le décalage des tableaux de la version 3
+        lesCas[nbCas] = (t_cas){ .preparer = preparerReference, .operation = operationReference,
+                                 .parametre = longueurs[i], .parLot = 64 };
+        snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "progresser_v3/longueur=%d", longueurs[i]);
+        nbCas++;
+    }
+    lesCas[nbCas] = (t_cas){ .preparer = preparerEnvironnements, .operation = operationAvancerEnvironnements,
+                             .parametre = 0, .parLot = 16 };
+    snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "avancerEnvironnements/environnements=%d",
+             NB_ENVIRONNEMENTS);
+    nbCas++;
+    for (i = 0; i < 4; i++) { // ajouterPomme() selon le remplissage du plateau
+        lesCas[nbCas] = (t_cas){ .preparer = preparerSerpent, .operation = operationAjouterPomme,
+                                 .parametre = (int)((long)LONGUEUR_CYCLE * remplissages[i] / 100), .parLot = 16 };
+        if (lesCas[nbCas].parametre < 1) {
+            lesCas[nbCas].parametre = 1;
+        }
+        snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "ajouterPomme/remplissage=%d%%", remplissages[i]);
+        nbCas++;
+    }
+    lesCas[nbCas] = (t_cas){ .preparer = preparerPartie, .operation = operationAleaBorne,
+                             .parametre = 0, .parLot = 256 };
+    snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "aleaBorne");
+    nbCas++;
+    lesCas[nbCas] = (t_cas){ .preparer = preparerPartie, .operation = operationInitPlateau,
+                             .parametre = 0, .parLot = 8 };
+    snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "initPlateau");
+    nbCas++;
+    lesCas[nbCas] = (t_cas){ .preparer = preparerPaves, .operation = operationInitPlateau,
+                             .parametre = 300, .parLot = 4 };
+    snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "initPlateau/paves=300,taille=2");
+    nbCas++;
+    for (i = 0; i < 2; i++) {
+        lesCas[nbCas] = (t_cas){ .preparer = preparerPlateauMoyen, .operation = operationIndexer,
+                                 .parametre = stockages[i], .parLot = 1 };
+        snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "indexerCasesLibres/plateau=%dx%d%s",
+                 PLATEAU_MOYEN, PLATEAU_MOYEN, suffixes[i]);
+        nbCas++;
+    }
+    lesCas[nbCas] = (t_cas){ .preparer = preparerAffichage, .operation = operationTrameDelta,
+                             .parametre = 1000, .parLot = 64 };
+    snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "trame_delta/longueur=1000");
+    nbCas++;
+    lesCas[nbCas] = (t_cas){ .preparer = preparerAffichage, .operation = operationTrameComplete,
+                             .parametre = 1000, .parLot = 1 };
+    snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "trame_complete/longueur=1000");
+    nbCas++;
+    for (i = 0; i < 2; i++) { // Le déplacement de la vue ne dépend pas de la taille du plateau
+        lesCas[nbCas] = (t_cas){ .preparer = preparerVue, .operation = operationDeplacerVue,
+                                 .parametre = i == 0 ? PLATEAU_MOYEN : GRAND_PLATEAU, .parLot = 16 };
+        snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "deplacer_vue/plateau=%dx%d",
+                 lesCas[nbCas].parametre, lesCas[nbCas].parametre);
+        nbCas++;
+    }
+    if (journal != NULL) { // Cas mesurés sur une partie enregistrée
+        if (!ouvrirLecture(&lecteur, journal)) {
+            return EXIT_FAILURE;
+        }
+        lesCas[nbCas] = (t_cas){ .preparer = preparerRejeu, .operation = operationRejeuMoteur,
+                                 .parametre = 0, .parLot = 256 };
+        snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "rejeu/moteur");
+        nbCas++;
+        lesCas[nbCas] = (t_cas){ .preparer = preparerRejeu, .operation = operationRejeuTrame,
+                                 .parametre = 0, .parLot = 64 };
+        snprintf(lesCas[nbCas].nom, sizeof(lesCas[nbCas].nom), "rejeu/trame");
+        nbCas++;
+    }
+
+    printf("%-40s %12s %12s %12s %12s %10s\n", "cas", "médiane ns", "p90 ns", "p99 ns", "moyenne ns", "allocs/op");
+    for (i = 0; i < nbCas; i++) {
+        lesMesures[i] = mesurer(&lesCas[i]);
+        printf("%-40s %12.1f %12.1f %12.1f %12.1f %10.3f\n", lesCas[i].nom, lesMesures[i].mediane,
+               lesMesures[i].centile90, lesMesures[i].centile99, lesMesures[i].moyenne, lesMesures[i].allocations);
+    }
+
+    if (comparer != NULL) { // Comparaison des médianes avec la référence
+        fichier = fopen(comparer, "r");
+        if (fichier == NULL) {
+            perror(comparer);
+            return EXIT_FAILURE;
+        }
+        printf("\nComparaison avec %s :\n", comparer);
+        while (fscanf(fichier, "%47s %lf", nom, &mediane) == 2) {
+            for (i = 0; i < nbCas; i++) {
+                if (strcmp(nom, lesCas[i].nom) == 0) {
+                    printf("%-40s %12.1f -> %12.1f ns (%+.1f %%)\n", nom, mediane, lesMesures[i].mediane,
+                           (lesMesures[i].mediane - mediane) * 100.0 / mediane);
+                }
+            }
+        }
+        fclose(fichier);
+    }
+
+    if (enregistrer != NULL) { // Enregistrement des médianes comme nouvelle référence
+        fichier = fopen(enregistrer, "w");
+        if (fichier == NULL) {
+            perror(enregistrer);
+            return EXIT_FAILURE;
+        }
+        for (i = 0; i < nbCas; i++) {
+            fprintf(fichier, "%s %.1f\n", lesCas[i].nom, lesMesures[i].mediane);
+        }
+        fclose(fichier);
+    }
+    partieDetruire(partie);
+    return EXIT_SUCCESS;
+}
+
+int64_t maintenant(){
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+void nouvellePartie(const t_config *config, uint64_t graine){
+    if (partie != NULL) {
+        partieDetruire(partie);
+    }
+    partie = partieCreer(config, graine, 0);
+    if (partie == NULL) {
+        perror("partieCreer");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void construireCycle(){
+    int i = 0, x, y, suivant;
+
+    for (y = 1; y <= HAUTEUR_CYCLE; y++) { // Serpentin sur les colonnes 2 à LARGEUR_CYCLE
+        for (x = 0; x < LARGEUR_CYCLE - 1; x++) {
+            cycleX[i] = (y % 2 == 1) ? x + 2 : LARGEUR_CYCLE - x;
+            cycleY[i] = y;
+            i++;
+        }
+    }
+    for (y = HAUTEUR_CYCLE; y >= 1; y--) { // Retour par la première colonne
+        cycleX[i] = 1;
+        cycleY[i] = y;
+        i++;
+    }
+
+    for (i = 0; i < LONGUEUR_CYCLE; i++) {
+        suivant = (i + 1) % LONGUEUR_CYCLE;
+        if (cycleX[suivant] > cycleX[i]) {
+            cycleDirection[i] = DROITE;
+        } else if (cycleX[suivant] < cycleX[i]) {
+            cycleDirection[i] = GAUCHE;
+        } else if (cycleY[suivant] > cycleY[i]) {
+            cycleDirection[i] = BAS;
+        } else {
+            cycleDirection[i] = HAUT;
+        }
+    }
+}
+
+void preparerSerpent(int longueur){
+    int i, j;
+
+    nouvellePartie(&configDefaut, 1);
+    for (j = 1; j < MAXTAB_Y - 1; j++) { // Retirer les pavés et la pomme
+        for (i = 1; i < MAXTAB_X - 1; i++) {
+            ecrireCase(partie, indiceCase(partie, i, j), ESPACE);
+        }
+    }
+    for (i = 0; i < LONGUEUR_CYCLE; i++) {
+        cycleCase[i] = indiceCase(partie, cycleX[i], cycleY[i]);
+    }
+    initSerpent(&partie->serpent, 0, 0);
+    for (i = 0; i < longueur; i++) {
+        ajouterTete(&partie->serpent, cycleCase[i]);
+    }
+    indexerCasesLibres(partie);
+    position = longueur - 1;
+    partie->direction = cycleDirection[position];
+}
+
+void operationProgresser(){
+    t_resultat resultat;
+
+    progresser(partie, cycleDirection[position], &resultat);
+    position++;
+    if (position == LONGUEUR_CYCLE) {
+        position = 0;
+    }
+}
+
+
+void preparerEnvironnements(int parametre){
+    size_t taille = tailleObservation(&configDefaut);
+    int i;
+
+    (void)parametre;
+    if (lesPlans == NULL) {
+        lesPlans = aligned_alloc(LIGNE_CACHE, NB_ENVIRONNEMENTS * taille);
+        if (lesPlans == NULL) {
+            perror("aligned_alloc");
+            exit(EXIT_FAILURE);
+        }
+        for (i = 0; i < NB_ENVIRONNEMENTS; i++) {
+            if (!initEnvironnement(&lesEnvironnements[i], &configDefaut, lesPlans + i * taille, i)) {
+                perror("initEnvironnement");
+                exit(EXIT_FAILURE);
+            }
+        }
+    }
+    for (i = 0; i < NB_ENVIRONNEMENTS; i++) {
+        reinitialiserEnvironnement(&lesEnvironnements[i], i);
+    }
+    initAlea(&aleaActions, 1, 0);
+}
+
+void operationAvancerEnvironnements(){
+    int actions[NB_ENVIRONNEMENTS];
+    float recompenses[NB_ENVIRONNEMENTS];
+    bool termines[NB_ENVIRONNEMENTS];
+    int i;
+
+    for (i = 0; i < NB_ENVIRONNEMENTS; i++) {
+        actions[i] = (int)aleaBorne(&aleaActions, NB_DIRECTIONS);
+    }
+    avancerEnvironnements(lesEnvironnements, NB_ENVIRONNEMENTS, actions, recompenses, termines);
+}
+
+void preparerPlateauCarre(int cote, int nbPaves, int stockage){
+    t_config config = configDefaut;
+
+    config.largeur = cote;
+    config.hauteur = cote;
+    config.nbPaves = nbPaves;
+    config.objectif = INT_MAX;
+    config.stockage = stockage;
+    nouvellePartie(&config, 1);
+    ecrireCase(partie, partie->pomme, ESPACE); // Retirer la pomme du chemin du serpent
+    libererCase(partie, partie->pomme);
+}
+
+void preparerGrandPlateau(int stockage){
+    preparerPlateauCarre(GRAND_PLATEAU, 0, stockage);
+}
+
+void preparerPlateauMoyen(int stockage){
+    preparerPlateauCarre(PLATEAU_MOYEN, PLATEAU_MOYEN, stockage);
+}
+
+void operationIndexer(){
+    indexerCasesLibres(partie);
+}
+
+void operationProgresserDroite(){
+    t_resultat resultat;
+
+    progresser(partie, DROITE, &resultat);
+}
+
+void preparerReference(int longueur){
+    int i;
+
+    for (i = 0; i < longueur; i++) { // La tête est au rang 0
+        refX[i] = cycleX[longueur - 1 - i];
+        refY[i] = cycleY[longueur - 1 - i];
+    }
+    refTaille = longueur;
+    position = longueur - 1;
+}
+
+void operationReference(){
+    int i, suivant;
+    bool collision = false;
+
+    suivant = position + 1 == LONGUEUR_CYCLE ? 0 : position + 1;
+    for (i = 0; i < refTaille; i++) {
+        if (cycleX[suivant] == refX[i] && cycleY[suivant] == refY[i]) {
+            collision = true;
+        }
+    }
+    for (i = refTaille - 1; i > 0; i--) {
+        refX[i] = refX[i - 1];
+        refY[i] = refY[i - 1];
+    }
+    refX[0] = cycleX[suivant];
+    refY[0] = cycleY[suivant] + collision; // Garder le résultat pour que la recherche ne soit pas supprimée
+    position = suivant;
+}
+
+void operationAjouterPomme(){
+    ajouterPomme(partie);
+    ecrireCase(partie, partie->pomme, ESPACE);
+    libererCase(partie, partie->pomme);
+}
+
+void operationAleaBorne(){
+    position += aleaBorne(&partie->alea, partie->nbCases); // Garder le résultat pour que le tirage ne soit pas supprimé
+}
+
+void preparerPartie(int parametre){
+    (void)parametre;
+    nouvellePartie(&configDefaut, 1);
+}
+
+void preparerPaves(int nombre){
+    t_config config = configDefaut;
+
+    config.nbPaves = nombre;
+    config.taillePave = 2;
+    nouvellePartie(&config, 1);
+}
+
+void operationInitPlateau(){
+    initPlateau(partie);
+}
+
+int ouvrirSortieNulle(){
+    int sortie = open("/dev/null", O_WRONLY);
+
+    if (sortie < 0) {
+        perror("/dev/null");
+        exit(EXIT_FAILURE);
+    }
+    if (tampon.sortie > 0) {
+        close(tampon.sortie);
+    }
+    return sortie;
+}
+
+void preparerAffichage(int longueur){
+    int sortie = ouvrirSortieNulle();
+
+    preparerSerpent(longueur);
+    initAffichage(sortie, partie, 0, 0);
+}
+
+void preparerVue(int cote){
+    int sortie = ouvrirSortieNulle();
+
+    preparerPlateauCarre(cote, cote * cote / 256, STOCKAGE_OCTETS); // Environ un dixième des cases en pavés
+    initAffichage(sortie, partie, LARGEUR_VUE, HAUTEUR_VUE);
+    dessinerVue(partie);
+    finTrame();
+}
+
+void operationDeplacerVue(){
+    if (vue.origineX + sensVue < 0 || vue.origineX + sensVue > partie->config.largeur - vue.largeur) {
+        sensVue = -sensVue; // Faire demi-tour au bord du plateau
+    }
+    vue.origineX += sensVue;
+    dessinerVue(partie);
+    finTrame();
+}
+
+void operationTrameDelta(){
+    int ancienneTete;
+    int pommeAffichee = 0;
+    t_resultat resultat;
+
+    ancienneTete = lireSegment(&partie->serpent, 0);
+    progresser(partie, cycleDirection[position], &resultat);
+    position = position + 1 == LONGUEUR_CYCLE ? 0 : position + 1;
+    marquerProgression(partie, ancienneTete, &resultat);
+    dessinerTrame(partie, &pommeAffichee);
+}
+
+void operationTrameComplete(){
+    dessinerPlateau(partie);
+    dessinerSerpent(partie);
+    finTrame();
+}
+
+void preparerRejeu(int parametre){
+    (void)parametre;
+    preparerAffichage(TAILLE_SERPENT);
+    nouvellePartie(&lecteur.config, lecteur.graine);
+    initAffichage(tampon.sortie, partie, 0, 0); // Le plateau rejoué peut avoir une autre taille
+    recommencerRejeu();
+}
+
+void recommencerRejeu(){
+    reinitialiserPartie(partie, lecteur.graine, lecteur.flux);
+    rembobinerLecture(&lecteur);
+    tick = 0;
+    cleRejouee = DROITE;
+    modifications.complet = true; // Le plateau entier a changé
+}
+
+t_resultat tickRejoue(){
+    char touche;
+    t_resultat resultat;
+
+    while (toucheRejouee(&lecteur, tick, &touche)) {
+        if (touche != PAUSE) {
+            cleRejouee = touche;
+        }
+    }
+    if (cleRejouee == ARRET) { // Fin de la partie enregistrée : elle recommence
+        recommencerRejeu();
+    }
+    resultat = avancerPartie(partie, cleRejouee);
+    tick++;
+    if (resultat.collision || resultat.gagne) {
+        recommencerRejeu();
+    }
+    return resultat;
+}
+
+void operationRejeuMoteur(){
+    tickRejoue();
+}
+
+void operationRejeuTrame(){
+    int ancienneTete;
+    int pommeAffichee = 0;
+    t_resultat resultat;
+
+    ancienneTete = lireSegment(&partie->serpent, 0);
+    resultat = tickRejoue();
+    marquerProgression(partie, ancienneTete, &resultat);
+    dessinerTrame(partie, &pommeAffichee);
+}
+
+t_mesure mesurer(const t_cas *cas){
+    static double durees[NB_LOTS];
+    t_mesure mesure;
+    int64_t debut;
+    long allocationsAvant;
+    double total = 0;
+    int lot, i;
+
+    cas->preparer(cas->parametre);
+    for (i = 0; i < cas->parLot * 10; i++) { // Échauffement des caches
+        cas->operation();
+    }
+
+    allocationsAvant = allocations;
+    for (lot = 0; lot < NB_LOTS; lot++) {
+        debut = maintenant();
+        for (i = 0; i < cas->parLot; i++) {
+            cas->operation();
+        }
+        durees[lot] = (double)(maintenant() - debut) / cas->parLot;
+        total += durees[lot];
+    }
+    mesure.allocations = (double)(allocations - allocationsAvant) / ((double)NB_LOTS * cas->parLot);
+
+    qsort(durees, NB_LOTS, sizeof(double), comparerDurees);
+    mesure.mediane = durees[NB_LOTS / 2];
+    mesure.centile90 = durees[NB_LOTS * 90 / 100];
+    mesure.centile99 = durees[NB_LOTS * 99 / 100];
+    mesure.moyenne = total / NB_LOTS;
+    return mesure;
+}
+
+int comparerDurees(const void *a, const void *b){
+    double da = *(const double *)a;
+    double db = *(const double *)b;
+
+    return (da > db) - (da < db);
+}
@@ -0,0 +1,284 @@
+/**
+* \file charge.c
+* \brief générateur de charge pour l'hôte de parties
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Ouvre un grand nombre de connexions vers hote.c, joue dans chacune des
+* directions au hasard et décode tous les messages reçus. À la fin sont
+* affichés le nombre d'images et de deltas reçus, le débit de deltas, le
+* délai avant la première image et le plus long silence d'une connexion
+* entre deux messages : avec une partie au plus lent à PERIODE_DEPART par
+* tick, un silence plus long révèle un hôte qui n'a pas tenu le rythme.
+*
+* Un seul fil surveille toutes les connexions avec epoll.
+*
+* Compilation : gcc -O2 -o charge charge.c diffusion.c moteur.c alea.c
+* Utilisation : ./charge [--socket chemin] [--sessions nombre] [--duree secondes]
+*                        [--touches touches_par_seconde] [--graine graine]
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+
+#include "diffusion.h"
+#include "alea.h"
+
+#define SESSIONS 1000 //constante pour le nombre de connexions par défaut
+#define DUREE 10 //constante pour la durée par défaut, en secondes
+#define TOUCHES 2 //constante pour le nombre de touches par seconde et par connexion par défaut
+#define TAILLE_RECEPTION 16384 //constante pour la taille du tampon de réception d'une connexion
+#define EVENEMENTS 256 //constante pour le nombre d'évènements lus par epoll_wait()
+#define ATTENTE 5 //constante pour l'attente maximale de epoll_wait(), en millisecondes
+
+/**
+ * \brief Une connexion à l'hôte et ses mesures.
+ */
+typedef struct {
+    int fd;                 // socket, -1 une fois fermée
+    uint8_t *reception;     // octets reçus pas encore décodés
+    size_t capacite;        // taille du tampon de réception
+    size_t recus;           // nombre d'octets en attente de décodage
+    int64_t ouverture;      // date de la connexion
+    int64_t dernierMessage; // date du dernier message reçu, 0 avant le premier
+    int64_t attente;        // délai entre la connexion et le premier message
+    int64_t prochaineTouche; // date de la prochaine touche à envoyer
+    int64_t silenceMax;     // plus long intervalle entre deux messages
+    long images;            // images reçues
+    long deltas;            // deltas reçus
+} t_connexion;
+
+t_connexion *connexions;
+int nbConnexions;
+
+/**
+ * \brief Donne la date actuelle de l'horloge monotone.
+ * \return La date en nanosecondes.
+ */
+int64_t maintenant();
+
+/**
+ * \brief Ouvre une connexion vers l'hôte et la surveille avec epoll.
+ * \param connexion La connexion.
+ * \param chemin Chemin de la socket de l'hôte.
+ * \param epoll Instance epoll.
+ * \param indice Numéro de la connexion, rendu par epoll.
+ * \return false en cas d'erreur, déjà affichée.
+ */
+bool ouvrirConnexion(t_connexion *connexion, const char *chemin, int epoll, int indice);
+
+/**
+ * \brief Lit et décode les messages disponibles d'une connexion.
+ * \param connexion La connexion.
+ * \param date La date actuelle.
+ * \return false si l'hôte a fermé la connexion ou envoyé un message invalide.
+ */
+bool recevoir(t_connexion *connexion, int64_t date);
+
+int main(int argc, char *argv[])
+{
+    struct epoll_event evenements[EVENEMENTS];
+    struct rlimit limite;
+    const char *chemin = "snake.sock";
+    long sessions = SESSIONS;
+    double duree = DUREE, touches = TOUCHES;
+    uint64_t graine = 1;
+    int64_t debut, fin, date, intervalle;
+    t_alea alea;
+    t_connexion *connexion;
+    long images = 0, deltas = 0, fermees = 0;
+    int64_t silenceMax = 0, attenteMax = 0;
+    char touche;
+    int epoll, n, i;
+
+    for (i = 1; i < argc; i++) { // Lecture des options
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            chemin = argv[++i];
+        }
+        else if (strcmp(argv[i], "--sessions") == 0 && i + 1 < argc) {
+            sessions = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--duree") == 0 && i + 1 < argc) {
+            duree = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--touches") == 0 && i + 1 < argc) {
+            touches = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--graine") == 0 && i + 1 < argc) {
+            if (!lireGraine(argv[++i], &graine)) {
+                fprintf(stderr, "%s : --graine attend un entier entre 0 et %llu, pas « %s »\n", argv[0],
+                        (unsigned long long)UINT64_MAX, argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else {
+            fprintf(stderr, "usage : %s [--socket chemin] [--sessions nombre] [--duree secondes]\n"
+                            "        %*s [--touches touches_par_seconde] [--graine graine]\n",
+                    argv[0], (int)strlen(argv[0]), "");
+            return EXIT_FAILURE;
+        }
+    }
+    if (sessions < 1 || sessions > 1000000 || duree <= 0 || touches <= 0) {
+        fprintf(stderr, "%s : il faut au moins une session, une durée et des touches positives\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (getrlimit(RLIMIT_NOFILE, &limite) == 0 && limite.rlim_cur < limite.rlim_max) {
+        limite.rlim_cur = limite.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limite);
+    }
+
+    nbConnexions = (int)sessions;
+    connexions = calloc(nbConnexions, sizeof(t_connexion));
+    epoll = epoll_create1(EPOLL_CLOEXEC);
+    if (connexions == NULL || epoll == -1) {
+        perror("charge");
+        return EXIT_FAILURE;
+    }
+    initAlea(&alea, graine, 0);
+    intervalle = (int64_t)(1e9 / touches);
+    debut = maintenant();
+    for (i = 0; i < nbConnexions; i++) {
+        if (!ouvrirConnexion(&connexions[i], chemin, epoll, i)) {
+            return EXIT_FAILURE;
+        }
+        // Les touches des connexions sont étalées sur tout l'intervalle
+        connexions[i].prochaineTouche = debut + aleaBorne(&alea, (uint32_t)(intervalle / 1000)) * (int64_t)1000;
+    }
+    printf("%d connexions ouvertes en %.1f ms\n", nbConnexions, (maintenant() - debut) / 1e6);
+    fflush(stdout);
+
+    debut = maintenant();
+    fin = debut + (int64_t)(duree * 1e9);
+    while ((date = maintenant()) < fin) {
+        n = epoll_wait(epoll, evenements, EVENEMENTS, ATTENTE);
+        date = maintenant();
+        for (i = 0; i < n; i++) {
+            connexion = &connexions[evenements[i].data.u32];
+            if (connexion->fd >= 0 && !recevoir(connexion, date)) {
+                close(connexion->fd);
+                connexion->fd = -1;
+                fermees++;
+            }
+        }
+        for (i = 0; i < nbConnexions; i++) { // Une direction au hasard pour chaque connexion dont c'est le tour
+            connexion = &connexions[i];
+            if (connexion->fd >= 0 && connexion->prochaineTouche <= date) {
+                touche = lesDirections[aleaBorne(&alea, NB_DIRECTIONS)];
+                send(connexion->fd, &touche, 1, MSG_NOSIGNAL | MSG_DONTWAIT);
+                connexion->prochaineTouche += intervalle;
+            }
+        }
+    }
+
+    for (i = 0; i < nbConnexions; i++) {
+        connexion = &connexions[i];
+        images += connexion->images;
+        deltas += connexion->deltas;
+        silenceMax = connexion->silenceMax > silenceMax ? connexion->silenceMax : silenceMax;
+        attenteMax = connexion->attente > attenteMax ? connexion->attente : attenteMax;
+        if (connexion->fd >= 0) {
+            close(connexion->fd);
+        }
+        free(connexion->reception);
+    }
+    printf("%ld images et %ld deltas reçus en %.1f s : %.0f deltas/s\n", images, deltas, duree, deltas / duree);
+    printf("Première image au plus %.1f ms après la connexion, plus long silence ensuite : %.1f ms\n",
+           attenteMax / 1e6, silenceMax / 1e6);
+    printf("%ld connexions fermées par l'hôte\n", fermees);
+    free(connexions);
+    close(epoll);
+    return EXIT_SUCCESS;
+}
+
+int64_t maintenant(){
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+bool ouvrirConnexion(t_connexion *connexion, const char *chemin, int epoll, int indice){
+    struct sockaddr_un adresse = { .sun_family = AF_UNIX };
+    struct epoll_event evenement = { .events = EPOLLIN, .data.u32 = (uint32_t)indice };
+
+    if (strlen(chemin) >= sizeof(adresse.sun_path)) {
+        fprintf(stderr, "%s : chemin trop long\n", chemin);
+        return false;
+    }
+    strcpy(adresse.sun_path, chemin);
+    connexion->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (connexion->fd == -1 || connect(connexion->fd, (struct sockaddr *)&adresse, sizeof(adresse)) == -1
+        || fcntl(connexion->fd, F_SETFL, O_NONBLOCK) == -1
+        || epoll_ctl(epoll, EPOLL_CTL_ADD, connexion->fd, &evenement) == -1) {
+        perror(chemin);
+        return false;
+    }
+    connexion->capacite = TAILLE_RECEPTION;
+    connexion->reception = malloc(connexion->capacite);
+    if (connexion->reception == NULL) {
+        perror("malloc");
+        return false;
+    }
+    connexion->ouverture = maintenant();
+    return true;
+}
+
+bool recevoir(t_connexion *connexion, int64_t date){
+    t_message message;
+    uint8_t *agrandie;
+    size_t position = 0;
+    ssize_t n;
+    long taille;
+
+    n = recv(connexion->fd, connexion->reception + connexion->recus, connexion->capacite - connexion->recus, 0);
+    if (n < 0) {
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+    }
+    if (n == 0) {
+        return false;
+    }
+    connexion->recus += (size_t)n;
+
+    while ((taille = lireMessage(connexion->reception + position, connexion->recus - position, &message)) > 0) {
+        if (message.type == MESSAGE_IMAGE) {
+            connexion->images++;
+        }
+        else {
+            connexion->deltas++;
+        }
+        if (connexion->dernierMessage == 0) {
+            connexion->attente = date - connexion->ouverture;
+        }
+        else if (date - connexion->dernierMessage > connexion->silenceMax) {
+            connexion->silenceMax = date - connexion->dernierMessage;
+        }
+        connexion->dernierMessage = date;
+        position += (size_t)taille;
+    }
+    if (taille < 0) {
+        return false;
+    }
+    memmove(connexion->reception, connexion->reception + position, connexion->recus - position);
+    connexion->recus -= position;
+    if (connexion->recus == connexion->capacite) { // Une image plus grande que le tampon
+        agrandie = realloc(connexion->reception, connexion->capacite * 2);
+        if (agrandie == NULL) {
+            return false;
+        }
+        connexion->reception = agrandie;
+        connexion->capacite *= 2;
+    }
+    return true;
+}
@@ -0,0 +1,504 @@
+/**
+* \file diffusion.c
+* \brief la diffusion d'une partie aux spectateurs
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+
+#include "diffusion.h"
+#include "affichage.h"
+#include "trace.h"
+
+#define MAX_VARINT 5 //constante pour la taille maximale d'un entier de 32 bits en varint
+#define ECOUTE MAX_SPECTATEURS //constante pour l'identifiant de la socket d'écoute dans epoll
+#define EVENEMENTS 64 //constante pour le nombre d'évènements lus par epoll_wait()
+
+/**
+ * \brief Écrit un entier en varint.
+ * \param octets Où écrire.
+ * \param valeur L'entier.
+ * \return Le nombre d'octets écrits.
+ */
+static int ecrireVarint(uint8_t *octets, uint32_t valeur){
+    int n = 0;
+
+    while (valeur >= 0x80) {
+        octets[n++] = (uint8_t)(valeur | 0x80);
+        valeur >>= 7;
+    }
+    octets[n++] = (uint8_t)valeur;
+    return n;
+}
+
+/**
+ * \brief Lit un entier en varint.
+ * \param octets Les octets.
+ * \param taille Nombre d'octets disponibles.
+ * \param position Position de l'entier, avancée après sa lecture.
+ * \param valeur L'entier lu.
+ * \return false si les octets s'arrêtent avant la fin de l'entier ou s'il est trop grand.
+ */
+static bool lireVarint(const uint8_t *octets, size_t taille, size_t *position, int *valeur){
+    uint32_t resultat = 0;
+    int decalage;
+
+    for (decalage = 0; decalage < 7 * MAX_VARINT && *position < taille; decalage += 7) {
+        resultat |= (uint32_t)(octets[*position] & 0x7f) << decalage;
+        if ((octets[(*position)++] & 0x80) == 0) {
+            if (resultat > INT32_MAX) {
+                return false;
+            }
+            *valeur = (int)resultat;
+            return true;
+        }
+    }
+    return false;
+}
+
+/**
+ * \brief Place la longueur au début d'un message construit à partir de MAX_VARINT octets.
+ * \param octets Tampon du message, qui commence par MAX_VARINT octets libres.
+ * \param fin Fin du message dans le tampon.
+ * \return La taille du message, longueur comprise, qui commence maintenant au début du tampon.
+ */
+static int placerLongueur(uint8_t *octets, int fin){
+    int n = ecrireVarint(octets, (uint32_t)(fin - MAX_VARINT));
+
+    memmove(octets + n, octets + MAX_VARINT, fin - MAX_VARINT);
+    return n + fin - MAX_VARINT;
+}
+
+/**
+ * \brief Écrit une case en abscisse puis ordonnée.
+ * \param octets Où écrire.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ * \return Le nombre d'octets écrits.
+ */
+static int ecrirePosition(uint8_t *octets, const t_partie *partie, int c){
+    int n = ecrireVarint(octets, (uint32_t)abscisse(partie, c));
+
+    return n + ecrireVarint(octets + n, (uint32_t)ordonnee(partie, c));
+}
+
+/**
+ * \brief Donne la fin du message qui commence à une position du tampon d'une sortie.
+ * \param sortie La sortie.
+ * \param debut Début du message.
+ * \return La fin du message.
+ */
+static int finMessage(const t_sortie *sortie, int debut){
+    size_t position = (size_t)debut;
+    int longueur = 0;
+
+    lireVarint(sortie->octets, (size_t)sortie->longueur, &position, &longueur);
+    return (int)position + longueur;
+}
+
+/**
+ * \brief Construit l'image de l'état actuel de la partie, si ce n'est pas déjà fait pour ce tick.
+ * \param diffusion La diffusion.
+ * \param partie La partie.
+ */
+static void construireImage(t_diffusion *diffusion, const t_partie *partie){
+    if (!diffusion->imageAJour) {
+        diffusion->tailleImage = ecrireImage(diffusion->image, partie);
+        diffusion->imageAJour = true;
+    }
+}
+
+/**
+ * \brief Ferme la socket d'un spectateur et libère sa place.
+ * \param diffusion La diffusion.
+ * \param spectateur Le spectateur.
+ */
+static void retirerSpectateur(t_diffusion *diffusion, t_spectateur *spectateur){
+    close(spectateur->fd); // Retire aussi la socket de epoll
+    libererSortie(&spectateur->sortie);
+    spectateur->fd = -1;
+    diffusion->nbSpectateurs--;
+}
+
+/**
+ * \brief Envoie les messages en attente d'un spectateur et surveille sa socket tant qu'il en reste.
+ * \param diffusion La diffusion.
+ * \param spectateur Le spectateur.
+ */
+static void envoyer(t_diffusion *diffusion, t_spectateur *spectateur){
+    struct epoll_event evenement;
+    bool surveiller;
+
+    if (!envoyerSortie(&spectateur->sortie, spectateur->fd, &diffusion->octets)) {
+        retirerSpectateur(diffusion, spectateur);
+        return;
+    }
+    surveiller = attenteSortie(&spectateur->sortie) > 0;
+    if (spectateur->surveilleEcriture != surveiller) { // epoll prévient quand la socket accepte à nouveau des octets
+        evenement.events = EPOLLIN | (surveiller ? EPOLLOUT : 0);
+        evenement.data.u32 = (uint32_t)(spectateur - diffusion->spectateurs);
+        epoll_ctl(diffusion->epoll, EPOLL_CTL_MOD, spectateur->fd, &evenement);
+        spectateur->surveilleEcriture = surveiller;
+    }
+}
+
+/**
+ * \brief Envoie l'image de la partie à un spectateur qui l'attend, s'il a la place de la recevoir.
+ * \param diffusion La diffusion.
+ * \param spectateur Le spectateur.
+ * \param partie La partie.
+ */
+static void ajouterImage(t_diffusion *diffusion, t_spectateur *spectateur, const t_partie *partie){
+    construireImage(diffusion, partie);
+    if (ajouterSortie(&spectateur->sortie, diffusion->image, diffusion->tailleImage)) {
+        spectateur->resynchroniser = false;
+        diffusion->images++;
+    }
+}
+
+/**
+ * \brief Accepte tous les spectateurs en attente de connexion.
+ * \param diffusion La diffusion.
+ * \param partie La partie, dont l'image est envoyée aux nouveaux spectateurs.
+ */
+static void accepterSpectateurs(t_diffusion *diffusion, const t_partie *partie){
+    struct epoll_event evenement;
+    t_spectateur *spectateur;
+    int fd, i;
+
+    while ((fd = accept(diffusion->ecoute, NULL, NULL)) >= 0) {
+        for (i = 0; i < MAX_SPECTATEURS && diffusion->spectateurs[i].fd >= 0; i++) {
+            // Chercher une place libre
+        }
+        if (i == MAX_SPECTATEURS) {
+            close(fd);
+            continue;
+        }
+        spectateur = &diffusion->spectateurs[i];
+        evenement.events = EPOLLIN;
+        evenement.data.u32 = (uint32_t)i;
+        if (!initSortie(&spectateur->sortie, RETARD_MAX + 2 * ((int)tailleMaxImage(partie) + TAILLE_DELTA))) {
+            close(fd);
+            continue;
+        }
+        if (fcntl(fd, F_SETFL, O_NONBLOCK) == -1 || epoll_ctl(diffusion->epoll, EPOLL_CTL_ADD, fd, &evenement) == -1) {
+            libererSortie(&spectateur->sortie);
+            close(fd);
+            continue;
+        }
+        spectateur->fd = fd;
+        spectateur->resynchroniser = true;
+        spectateur->surveilleEcriture = false;
+        diffusion->nbSpectateurs++;
+        diffusion->connexions++;
+        ajouterImage(diffusion, spectateur, partie);
+        envoyer(diffusion, spectateur);
+    }
+}
+
+size_t tailleMaxImage(const t_partie *partie){
+    // Les cases, le type et sept entiers en varint, longueur comprise
+    return (size_t)partie->config.largeur * partie->config.hauteur + 1 + 7 * MAX_VARINT;
+}
+
+int ecrireImage(uint8_t *octets, const t_partie *partie){
+    int tete = lireSegment(&partie->serpent, 0);
+    int n = MAX_VARINT;
+    int x, y, c;
+
+    octets[n++] = MESSAGE_IMAGE;
+    n += ecrireVarint(octets + n, (uint32_t)partie->config.largeur);
+    n += ecrireVarint(octets + n, (uint32_t)partie->config.hauteur);
+    n += ecrireVarint(octets + n, (uint32_t)partie->pommeMange);
+    n += ecrireVarint(octets + n, (uint32_t)partie->config.objectif);
+    n += ecrirePosition(octets + n, partie, tete);
+    for (y = 0; y < partie->config.hauteur; y++) {
+        c = indiceCase(partie, 0, y);
+        for (x = 0; x < partie->config.largeur; x++, c++) {
+            if (c == tete) {
+                octets[n++] = TETE;
+            }
+            else if (estSerpent(&partie->serpent, c)) {
+                octets[n++] = ANNEAUX;
+            }
+            else {
+                octets[n++] = (uint8_t)lireCase(partie, c);
+            }
+        }
+    }
+    return placerLongueur(octets, n);
+}
+
+int ecrireDelta(uint8_t *octets, const t_partie *partie, const t_resultat *resultat){
+    int drapeaux = 0;
+    int n = MAX_VARINT;
+
+    if (!resultat->pomme) {
+        drapeaux |= DELTA_QUEUE;
+    }
+    else {
+        drapeaux |= DELTA_MANGEE;
+        if (estPomme(partie, partie->pomme)) {
+            drapeaux |= DELTA_NOUVELLE;
+        }
+    }
+    if (resultat->collision) {
+        drapeaux |= DELTA_COLLISION;
+    }
+    if (resultat->gagne) {
+        drapeaux |= DELTA_GAGNE;
+    }
+    octets[n++] = MESSAGE_DELTA;
+    octets[n++] = (uint8_t)drapeaux;
+    n += ecrirePosition(octets + n, partie, lireSegment(&partie->serpent, 0));
+    if (drapeaux & DELTA_QUEUE) {
+        n += ecrirePosition(octets + n, partie, resultat->queue);
+    }
+    if (drapeaux & DELTA_NOUVELLE) {
+        n += ecrirePosition(octets + n, partie, partie->pomme);
+    }
+    return placerLongueur(octets, n);
+}
+
+bool initSortie(t_sortie *sortie, int capacite){
+    sortie->octets = malloc(capacite);
+    sortie->capacite = capacite;
+    sortie->longueur = 0;
+    sortie->envoye = 0;
+    sortie->debutMessage = 0;
+    return sortie->octets != NULL;
+}
+
+void libererSortie(t_sortie *sortie){
+    free(sortie->octets);
+    sortie->octets = NULL;
+}
+
+bool ajouterSortie(t_sortie *sortie, const uint8_t *octets, int taille){
+    if (sortie->longueur + taille > sortie->capacite && sortie->debutMessage > 0) {
+        memmove(sortie->octets, sortie->octets + sortie->debutMessage, sortie->longueur - sortie->debutMessage);
+        sortie->longueur -= sortie->debutMessage;
+        sortie->envoye -= sortie->debutMessage;
+        sortie->debutMessage = 0;
+    }
+    if (sortie->longueur + taille > sortie->capacite) {
+        return false;
+    }
+    memcpy(sortie->octets + sortie->longueur, octets, taille);
+    sortie->longueur += taille;
+    return true;
+}
+
+void abandonnerSortie(t_sortie *sortie){
+    sortie->longueur = sortie->envoye > sortie->debutMessage ? finMessage(sortie, sortie->debutMessage) : sortie->envoye;
+}
+
+int attenteSortie(const t_sortie *sortie){
+    return sortie->longueur - sortie->envoye;
+}
+
+bool envoyerSortie(t_sortie *sortie, int fd, long *octets){
+    ssize_t n;
+
+    while (sortie->envoye < sortie->longueur) {
+        TRACE_DEBUT("send");
+        n = send(fd, sortie->octets + sortie->envoye, sortie->longueur - sortie->envoye, MSG_NOSIGNAL);
+        TRACE_FIN("send", n);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            break; // La socket est pleine
+        }
+        if (n <= 0) {
+            return false;
+        }
+        sortie->envoye += (int)n;
+        *octets += n;
+    }
+
+    if (sortie->envoye == sortie->longueur) { // Tout est parti : le tampon repart du début
+        sortie->longueur = 0;
+        sortie->envoye = 0;
+        sortie->debutMessage = 0;
+    }
+    else {
+        while (finMessage(sortie, sortie->debutMessage) <= sortie->envoye) {
+            sortie->debutMessage = finMessage(sortie, sortie->debutMessage);
+        }
+    }
+    return true;
+}
+
+t_diffusion *diffusionCreer(const char *chemin, const t_partie *partie){
+    t_diffusion *diffusion;
+    struct sockaddr_un adresse = { .sun_family = AF_UNIX };
+    struct epoll_event evenement = { .events = EPOLLIN, .data.u32 = ECOUTE };
+    int i, erreur;
+
+    if (strlen(chemin) >= sizeof(adresse.sun_path)) {
+        errno = ENAMETOOLONG;
+        return NULL;
+    }
+    diffusion = calloc(1, sizeof(t_diffusion));
+    if (diffusion == NULL) {
+        return NULL;
+    }
+    strcpy(diffusion->chemin, chemin);
+    strcpy(adresse.sun_path, chemin);
+    for (i = 0; i < MAX_SPECTATEURS; i++) {
+        diffusion->spectateurs[i].fd = -1;
+    }
+    diffusion->image = malloc(tailleMaxImage(partie));
+    diffusion->ecoute = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    diffusion->epoll = epoll_create1(EPOLL_CLOEXEC);
+    unlink(chemin);
+    if (diffusion->image == NULL || diffusion->ecoute == -1 || diffusion->epoll == -1
+        || bind(diffusion->ecoute, (struct sockaddr *)&adresse, sizeof(adresse)) == -1
+        || listen(diffusion->ecoute, SOMAXCONN) == -1
+        || epoll_ctl(diffusion->epoll, EPOLL_CTL_ADD, diffusion->ecoute, &evenement) == -1) {
+        erreur = errno;
+        diffusionDetruire(diffusion);
+        errno = erreur;
+        return NULL;
+    }
+    return diffusion;
+}
+
+void diffusionDetruire(t_diffusion *diffusion){
+    int i;
+
+    for (i = 0; i < MAX_SPECTATEURS; i++) {
+        if (diffusion->spectateurs[i].fd >= 0) {
+            retirerSpectateur(diffusion, &diffusion->spectateurs[i]);
+        }
+    }
+    if (diffusion->ecoute >= 0) {
+        close(diffusion->ecoute);
+        unlink(diffusion->chemin);
+    }
+    if (diffusion->epoll >= 0) {
+        close(diffusion->epoll);
+    }
+    free(diffusion->image);
+    free(diffusion);
+}
+
+void servirSpectateurs(t_diffusion *diffusion, const t_partie *partie){
+    struct epoll_event evenements[EVENEMENTS];
+    t_spectateur *spectateur;
+    uint8_t poubelle[256];
+    ssize_t lus;
+    int n, i;
+
+    do {
+        n = epoll_wait(diffusion->epoll, evenements, EVENEMENTS, 0);
+        for (i = 0; i < n; i++) {
+            if (evenements[i].data.u32 == ECOUTE) {
+                accepterSpectateurs(diffusion, partie);
+                continue;
+            }
+            spectateur = &diffusion->spectateurs[evenements[i].data.u32];
+            if (spectateur->fd < 0) {
+                continue; // Retiré plus tôt dans la même série d'évènements
+            }
+            if (evenements[i].events & EPOLLIN) { // Un spectateur n'envoie rien : seule la fermeture compte
+                lus = recv(spectateur->fd, poubelle, sizeof(poubelle), 0);
+                if (lus == 0 || (lus < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                    retirerSpectateur(diffusion, spectateur);
+                    continue;
+                }
+            }
+            if (evenements[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+                envoyer(diffusion, spectateur);
+            }
+        }
+    } while (n == EVENEMENTS);
+}
+
+void diffuserTick(t_diffusion *diffusion, const t_partie *partie, const t_resultat *resultat){
+    uint8_t delta[TAILLE_DELTA];
+    t_spectateur *spectateur;
+    int taille, i;
+
+    diffusion->imageAJour = false;
+    if (diffusion->nbSpectateurs == 0) {
+        return;
+    }
+    taille = ecrireDelta(delta, partie, resultat);
+
+    for (i = 0; i < MAX_SPECTATEURS; i++) {
+        spectateur = &diffusion->spectateurs[i];
+        if (spectateur->fd < 0) {
+            continue;
+        }
+        // Trop en retard : les deltas en attente sont abandonnés, une image en cours d'envoi ne compte pas
+        if (!spectateur->resynchroniser
+            && attenteSortie(&spectateur->sortie) + taille > RETARD_MAX + (int)tailleMaxImage(partie)) {
+            abandonnerSortie(&spectateur->sortie);
+            spectateur->resynchroniser = true;
+            diffusion->decrochages++;
+        }
+        if (spectateur->resynchroniser) { // L'image remplace le delta de ce tick
+            ajouterImage(diffusion, spectateur, partie);
+        }
+        else if (ajouterSortie(&spectateur->sortie, delta, taille)) {
+            diffusion->deltas++;
+        }
+        envoyer(diffusion, spectateur);
+    }
+}
+
+long lireMessage(const uint8_t *octets, size_t taille, t_message *message){
+    size_t position = 0;
+    size_t fin;
+    int longueur;
+
+    if (!lireVarint(octets, taille, &position, &longueur)) {
+        return (position < taille || position >= MAX_VARINT) ? -1 : 0; // Trop long, ou pas encore reçu
+    }
+    if (taille - position < (size_t)longueur) {
+        return 0;
+    }
+    fin = position + longueur;
+    if (longueur == 0) {
+        return -1;
+    }
+    message->type = octets[position++];
+    if (message->type == MESSAGE_IMAGE) {
+        if (!lireVarint(octets, fin, &position, &message->largeur)
+            || !lireVarint(octets, fin, &position, &message->hauteur)
+            || !lireVarint(octets, fin, &position, &message->pommes)
+            || !lireVarint(octets, fin, &position, &message->objectif)
+            || !lireVarint(octets, fin, &position, &message->teteX)
+            || !lireVarint(octets, fin, &position, &message->teteY)
+            || fin - position != (size_t)message->largeur * message->hauteur) {
+            return -1;
+        }
+        message->cases = octets + position;
+        return (long)fin;
+    }
+    if (message->type != MESSAGE_DELTA || !lireVarint(octets, fin, &position, &message->drapeaux)
+        || !lireVarint(octets, fin, &position, &message->teteX)
+        || !lireVarint(octets, fin, &position, &message->teteY)) {
+        return -1;
+    }
+    if ((message->drapeaux & DELTA_QUEUE)
+        && (!lireVarint(octets, fin, &position, &message->queueX) || !lireVarint(octets, fin, &position, &message->queueY))) {
+        return -1;
+    }
+    if ((message->drapeaux & DELTA_NOUVELLE)
+        && (!lireVarint(octets, fin, &position, &message->pommeX) || !lireVarint(octets, fin, &position, &message->pommeY))) {
+        return -1;
+    }
+    return (long)fin;
+}
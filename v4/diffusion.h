@@ -0,0 +1,229 @@
+/**
+* \file diffusion.h
+* \brief la diffusion d'une partie aux spectateurs
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Une partie en cours est publiée sur une socket Unix : chaque spectateur
+* qui s'y connecte reçoit une image du plateau, puis un delta par tick.
+* Le jeu ne bloque jamais sur un spectateur : les sockets sont non
+* bloquantes, surveillées par epoll, et les messages en attente d'un
+* spectateur sont gardés dans son tampon. Un spectateur trop lent pour
+* suivre perd ses deltas en attente et reçoit une nouvelle image.
+*
+* Chaque message commence par sa longueur, puis son type, tous les entiers
+* étant codés en varint comme dans les journaux :
+*   - MESSAGE_IMAGE : largeur, hauteur, pommes mangées, objectif, abscisse
+*     et ordonnée de la tête, puis largeur * hauteur octets, le caractère
+*     affiché de chaque case ligne par ligne (TETE, ANNEAUX, BORDURE, POMME ou ESPACE) ;
+*   - MESSAGE_DELTA : les drapeaux DELTA_*, la tête, puis la case libérée
+*     par la queue si DELTA_QUEUE et la nouvelle pomme si DELTA_NOUVELLE,
+*     chaque case en abscisse puis ordonnée.
+*
+*/
+#ifndef DIFFUSION_H
+#define DIFFUSION_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "moteur.h"
+
+#define MAX_SPECTATEURS 1000 //constante pour le nombre maximum de spectateurs connectés
+#define RETARD_MAX 4096 //constante pour les octets de deltas en attente au-delà desquels un spectateur décroche
+#define TAILLE_DELTA 32 //constante pour la taille maximale d'un message de delta
+#define MESSAGE_IMAGE 'I' //constante pour le type d'un message d'image du plateau
+#define MESSAGE_DELTA 'D' //constante pour le type d'un message de delta d'un tick
+#define DELTA_QUEUE 1 //constante pour un delta où la queue a libéré une case
+#define DELTA_MANGEE 2 //constante pour un delta où une pomme a été mangée
+#define DELTA_NOUVELLE 4 //constante pour un delta où une nouvelle pomme est apparue
+#define DELTA_COLLISION 8 //constante pour un delta terminé par une collision
+#define DELTA_GAGNE 16 //constante pour un delta qui gagne la partie
+
+/**
+ * \brief Messages en attente d'envoi sur une socket non bloquante.
+ *
+ * Les octets de debutMessage à longueur sont en attente, ceux avant envoye
+ * sont déjà partis. debutMessage est toujours le début d'un message : un
+ * message commencé est envoyé en entier, même quand les suivants sont abandonnés.
+ */
+typedef struct {
+    uint8_t *octets;         // messages en attente
+    int capacite;            // taille du tampon
+    int longueur;            // fin des messages en attente
+    int envoye;              // fin des octets déjà envoyés
+    int debutMessage;        // début du premier message pas entièrement envoyé
+} t_sortie;
+
+/**
+ * \brief Un spectateur connecté.
+ */
+typedef struct {
+    int fd;                  // socket du spectateur, -1 si la place est libre
+    t_sortie sortie;         // messages en attente d'envoi
+    bool resynchroniser;     // le spectateur attend une image à la place des deltas
+    bool surveilleEcriture;  // epoll prévient quand la socket accepte à nouveau des octets
+} t_spectateur;
+
+/**
+ * \brief Socket d'écoute, spectateurs et image partagée.
+ *
+ * L'image de la partie n'est construite qu'une fois par tick, et seulement
+ * si un spectateur en a besoin.
+ */
+typedef struct {
+    int ecoute;              // socket d'écoute
+    int epoll;               // instance epoll qui surveille toutes les sockets
+    char chemin[108];        // chemin de la socket, supprimé à la fin
+    t_spectateur spectateurs[MAX_SPECTATEURS];
+    int nbSpectateurs;       // nombre de spectateurs connectés
+    uint8_t *image;          // message d'image de la partie
+    int tailleImage;         // taille du message d'image
+    bool imageAJour;         // l'image correspond à l'état actuel de la partie
+    long connexions;         // spectateurs acceptés depuis le début
+    long decrochages;        // spectateurs trop lents renvoyés à une image
+    long images;             // images envoyées
+    long deltas;             // deltas envoyés
+    long octets;             // octets envoyés
+} t_diffusion;
+
+/**
+ * \brief Un message décodé par un spectateur.
+ */
+typedef struct {
+    int type;            // MESSAGE_IMAGE ou MESSAGE_DELTA
+    int largeur;         // image : largeur du plateau
+    int hauteur;         // image : hauteur du plateau
+    int pommes;          // image : nombre de pommes mangées
+    int objectif;        // image : nombre de pommes pour gagner
+    const uint8_t *cases; // image : caractère de chaque case, ligne par ligne
+    int drapeaux;        // delta : drapeaux DELTA_*
+    int teteX;           // abscisse de la tête
+    int teteY;           // ordonnée de la tête
+    int queueX;          // delta : abscisse de la case libérée par la queue
+    int queueY;          // delta : ordonnée de la case libérée par la queue
+    int pommeX;          // delta : abscisse de la nouvelle pomme
+    int pommeY;          // delta : ordonnée de la nouvelle pomme
+} t_message;
+
+/**
+ * \brief Donne la taille maximale d'un message d'image d'une partie.
+ * \param partie La partie.
+ * \return La taille en octets.
+ */
+size_t tailleMaxImage(const t_partie *partie);
+
+/**
+ * \brief Écrit le message d'image de l'état actuel d'une partie.
+ * \param octets Où écrire, au moins tailleMaxImage(partie) octets.
+ * \param partie La partie.
+ * \return La taille du message, longueur comprise.
+ */
+int ecrireImage(uint8_t *octets, const t_partie *partie);
+
+/**
+ * \brief Écrit le message de delta d'un tick.
+ * \param octets Où écrire, au moins TAILLE_DELTA octets.
+ * \param partie La partie après le tick.
+ * \param resultat Le résultat du tick.
+ * \return La taille du message, longueur comprise.
+ */
+int ecrireDelta(uint8_t *octets, const t_partie *partie, const t_resultat *resultat);
+
+/**
+ * \brief Alloue le tampon d'une sortie vide.
+ * \param sortie La sortie.
+ * \param capacite Taille du tampon.
+ * \return false si la mémoire manque.
+ */
+bool initSortie(t_sortie *sortie, int capacite);
+
+/**
+ * \brief Libère le tampon d'une sortie.
+ * \param sortie La sortie.
+ */
+void libererSortie(t_sortie *sortie);
+
+/**
+ * \brief Ajoute un message à une sortie s'il y a la place.
+ *
+ * Les messages déjà envoyés sont d'abord retirés du début du tampon.
+ *
+ * \param sortie La sortie.
+ * \param octets Le message, longueur comprise.
+ * \param taille Taille du message.
+ * \return false si le tampon est trop plein.
+ */
+bool ajouterSortie(t_sortie *sortie, const uint8_t *octets, int taille);
+
+/**
+ * \brief Abandonne les messages en attente d'une sortie, sauf celui qui est commencé.
+ * \param sortie La sortie.
+ */
+void abandonnerSortie(t_sortie *sortie);
+
+/**
+ * \brief Donne le nombre d'octets en attente d'une sortie.
+ * \param sortie La sortie.
+ * \return Le nombre d'octets.
+ */
+int attenteSortie(const t_sortie *sortie);
+
+/**
+ * \brief Envoie les messages en attente d'une sortie, autant que la socket en accepte.
+ * \param sortie La sortie.
+ * \param fd La socket, non bloquante.
+ * \param octets Nombre d'octets envoyés, ajouté au compteur.
+ * \return false si la socket est fermée ou en erreur.
+ */
+bool envoyerSortie(t_sortie *sortie, int fd, long *octets);
+
+/**
+ * \brief Crée la socket de diffusion d'une partie.
+ *
+ * Un fichier existant au même chemin est remplacé.
+ *
+ * \param chemin Chemin de la socket Unix.
+ * \param partie La partie diffusée, qui donne la taille des images.
+ * \return La diffusion, ou NULL si la socket ne peut pas être créée (errno indique pourquoi).
+ */
+t_diffusion *diffusionCreer(const char *chemin, const t_partie *partie);
+
+/**
+ * \brief Ferme toutes les sockets, supprime le chemin et libère la diffusion.
+ * \param diffusion La diffusion.
+ */
+void diffusionDetruire(t_diffusion *diffusion);
+
+/**
+ * \brief Traite les évènements des sockets sans attendre.
+ *
+ * Les nouveaux spectateurs sont acceptés et reçoivent une image, les
+ * messages en attente partent vers les sockets de nouveau disponibles et
+ * les spectateurs partis sont retirés.
+ *
+ * \param diffusion La diffusion.
+ * \param partie La partie diffusée.
+ */
+void servirSpectateurs(t_diffusion *diffusion, const t_partie *partie);
+
+/**
+ * \brief Envoie le delta d'un tick à tous les spectateurs, sans jamais attendre.
+ * \param diffusion La diffusion.
+ * \param partie La partie après le tick.
+ * \param resultat Le résultat du tick.
+ */
+void diffuserTick(t_diffusion *diffusion, const t_partie *partie, const t_resultat *resultat);
+
+/**
+ * \brief Décode le premier message d'une suite d'octets reçus.
+ * \param octets Les octets reçus.
+ * \param taille Nombre d'octets reçus.
+ * \param message Le message décodé ; pour une image, cases pointe dans octets.
+ * \return La taille du message, 0 s'il n'est pas encore complet, -1 s'il est invalide.
+ */
+long lireMessage(const uint8_t *octets, size_t taille, t_message *message);
+
+#endif
@@ -0,0 +1,140 @@
+/**
+* \file environnement.c
+* \brief le jeu snake comme environnement d'entraînement
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+
+#include "environnement.h"
+
+/**
+ * \brief Donne la place d'une case du plateau dans un plan de l'observation.
+ * \param environnement L'environnement.
+ * \param c Numéro de la case.
+ * \return L'indice de la case dans le plan.
+ */
+static int positionPlan(const t_environnement *environnement, int c){
+    int pas = environnement->partie->pas;
+    int ligne = c / pas; // Une seule division pour l'abscisse et l'ordonnée
+
+    return (ligne - 1) * environnement->largeur + c - ligne * pas - 1;
+}
+
+/**
+ * \brief Écrit une case dans un plan de l'observation.
+ * \param environnement L'environnement.
+ * \param plan Numéro du plan.
+ * \param c Numéro de la case.
+ * \param valeur 1 si la case contient ce que décrit le plan, 0 sinon.
+ */
+static void ecrirePlan(t_environnement *environnement, int plan, int c, uint8_t valeur){
+    environnement->plans[plan * environnement->taillePlan + positionPlan(environnement, c)] = valeur;
+}
+
+/**
+ * \brief Commence l'épisode en cours de l'environnement et écrit toute l'observation.
+ * \param environnement L'environnement.
+ */
+static void commencerEpisode(t_environnement *environnement){
+    t_partie *partie = environnement->partie;
+    uint8_t *murs = environnement->plans + PLAN_MURS * environnement->taillePlan;
+    int i, x, y, c;
+
+    reinitialiserPartie(partie, environnement->graine, environnement->episode);
+    environnement->pas = 0;
+    environnement->termine = false;
+
+    memset(environnement->plans, 0, (size_t)NB_PLANS * environnement->taillePlan);
+    for (y = 0; y < partie->config.hauteur; y++) {
+        c = indiceCase(partie, 0, y);
+        for (x = 0; x < partie->config.largeur; x++, c++) {
+            murs[y * environnement->largeur + x] = estMur(partie, c);
+        }
+    }
+    for (i = 1; i < partie->serpent.taille; i++) {
+        ecrirePlan(environnement, PLAN_CORPS, lireSegment(&partie->serpent, i), 1);
+    }
+    ecrirePlan(environnement, PLAN_TETE, lireSegment(&partie->serpent, 0), 1);
+    ecrirePlan(environnement, PLAN_POMME, partie->pomme, 1);
+}
+
+size_t tailleObservation(const t_config *config){
+    return (size_t)NB_PLANS * config->largeur * config->hauteur;
+}
+
+bool initEnvironnement(t_environnement *environnement, const t_config *config, uint8_t *plans, uint64_t graine){
+    if ((uintptr_t)plans % LIGNE_CACHE != 0) {
+        return false;
+    }
+    environnement->partie = partieCreer(config, graine, 0);
+    if (environnement->partie == NULL) {
+        return false;
+    }
+    environnement->plans = plans;
+    environnement->largeur = config->largeur;
+    environnement->taillePlan = config->largeur * config->hauteur;
+    reinitialiserEnvironnement(environnement, graine);
+    return true;
+}
+
+void libererEnvironnement(t_environnement *environnement){
+    partieDetruire(environnement->partie);
+    environnement->partie = NULL;
+}
+
+void reinitialiserEnvironnement(t_environnement *environnement, uint64_t graine){
+    environnement->graine = graine;
+    environnement->episode = 0;
+    commencerEpisode(environnement);
+}
+
+float avancerEnvironnement(t_environnement *environnement, int action){
+    t_partie *partie = environnement->partie;
+    int ancienneTete = lireSegment(&partie->serpent, 0);
+    int anciennePomme = partie->pomme;
+    t_resultat resultat;
+
+    if (environnement->termine) {
+        return RECOMPENSE_PAS;
+    }
+    resultat = avancerPartie(partie, (action >= 0 && action < NB_DIRECTIONS) ? lesDirections[action] : ' ');
+    environnement->pas++;
+    environnement->termine = resultat.collision || resultat.gagne;
+
+    // Seules les cases touchées par le tick changent dans l'observation
+    ecrirePlan(environnement, PLAN_TETE, ancienneTete, 0);
+    ecrirePlan(environnement, PLAN_CORPS, ancienneTete, 1);
+    if (resultat.pomme) {
+        ecrirePlan(environnement, PLAN_POMME, anciennePomme, 0);
+        if (!resultat.gagne) {
+            ecrirePlan(environnement, PLAN_POMME, partie->pomme, 1);
+        }
+    }
+    else {
+        ecrirePlan(environnement, PLAN_CORPS, resultat.queue, 0);
+    }
+    ecrirePlan(environnement, PLAN_TETE, lireSegment(&partie->serpent, 0), 1);
+
+    if (resultat.collision) {
+        return RECOMPENSE_MORT;
+    }
+    return resultat.pomme ? RECOMPENSE_POMME : RECOMPENSE_PAS;
+}
+
+void avancerEnvironnements(t_environnement *environnements, int nombre, const int *actions,
+                           float *recompenses, bool *termines){
+    int i;
+
+    for (i = 0; i < nombre; i++) {
+        recompenses[i] = avancerEnvironnement(&environnements[i], actions[i]);
+        termines[i] = environnements[i].termine;
+        if (termines[i]) { // Épisode suivant de la même graine
+            environnements[i].episode++;
+            commencerEpisode(&environnements[i]);
+        }
+    }
+}
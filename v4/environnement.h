@@ -0,0 +1,116 @@
+/**
+* \file environnement.h
+* \brief le jeu snake comme environnement d'entraînement
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Un environnement enveloppe une partie pour un agent qui apprend à jouer :
+* reinitialiserEnvironnement() commence un épisode, avancerEnvironnement()
+* joue une action et rend la récompense, et avancerEnvironnements() fait
+* la même chose pour un tableau d'environnements.
+*
+* L'observation est écrite directement dans des plans fournis par l'appelant :
+* NB_PLANS plans de largeur * hauteur octets, les uns après les autres, la
+* case (x, y) du plateau à l'octet y * largeur + x de chaque plan, qui vaut 1
+* si la case contient ce que décrit le plan et 0 sinon. Les plans sont
+* entièrement écrits au début d'un épisode, puis seules les cases modifiées
+* par chaque action le sont : une action ne copie jamais le plateau et
+* n'alloue rien.
+*
+* Compilation en bibliothèque partagée, par exemple pour ctypes :
+*   gcc -O2 -shared -fPIC -o libsnake.so environnement.c moteur.c alea.c
+*
+*/
+#ifndef ENVIRONNEMENT_H
+#define ENVIRONNEMENT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "moteur.h"
+
+#define NB_PLANS 4 //constante pour le nombre de plans d'une observation
+#define PLAN_MURS 0 //constante pour le plan des bordures et des pavés
+#define PLAN_CORPS 1 //constante pour le plan des anneaux du serpent, tête exclue
+#define PLAN_TETE 2 //constante pour le plan de la tête du serpent
+#define PLAN_POMME 3 //constante pour le plan de la pomme
+#define RECOMPENSE_POMME 1.0f //constante pour la récompense d'une pomme mangée
+#define RECOMPENSE_MORT (-1.0f) //constante pour la récompense d'une collision
+#define RECOMPENSE_PAS 0.0f //constante pour la récompense d'une action sans pomme ni collision
+
+/**
+ * \brief Une partie et ses plans d'observation.
+ *
+ * Le numéro de l'épisode sert de flux au générateur de la partie :
+ * les épisodes d'une même graine sont différents et reproductibles.
+ */
+typedef struct {
+    t_partie *partie;   // la partie, réutilisée d'un épisode à l'autre
+    uint8_t *plans;     // plans de l'observation, fournis par l'appelant
+    int largeur;        // largeur des plans, celle du plateau
+    int taillePlan;     // nombre d'octets d'un plan
+    uint64_t graine;    // graine donnée à reinitialiserEnvironnement()
+    uint64_t episode;   // numéro de l'épisode depuis reinitialiserEnvironnement()
+    long pas;           // nombre d'actions jouées pendant l'épisode
+    bool termine;       // l'épisode est fini : collision ou partie gagnée
+} t_environnement;
+
+/**
+ * \brief Donne la taille des plans d'observation pour des réglages.
+ * \param config Les réglages.
+ * \return Le nombre d'octets des NB_PLANS plans.
+ */
+size_t tailleObservation(const t_config *config);
+
+/**
+ * \brief Prépare un environnement et commence son premier épisode.
+ * \param environnement L'environnement.
+ * \param config Réglages des parties, à vérifier avec erreurConfig().
+ * \param plans Plans de l'observation, de tailleObservation(config) octets alignés sur LIGNE_CACHE.
+ * \param graine Graine des épisodes.
+ * \return false si les réglages sont invalides, si les plans ne sont pas alignés ou si la mémoire manque.
+ */
+bool initEnvironnement(t_environnement *environnement, const t_config *config, uint8_t *plans, uint64_t graine);
+
+/**
+ * \brief Libère la partie d'un environnement. Les plans restent à l'appelant.
+ * \param environnement L'environnement.
+ */
+void libererEnvironnement(t_environnement *environnement);
+
+/**
+ * \brief Recommence au premier épisode d'une graine et écrit toute l'observation.
+ * \param environnement L'environnement.
+ * \param graine Graine des épisodes.
+ */
+void reinitialiserEnvironnement(t_environnement *environnement, uint64_t graine);
+
+/**
+ * \brief Joue une action et met à jour les cases modifiées de l'observation.
+ *
+ * Une fois l'épisode terminé, l'action est ignorée jusqu'à la réinitialisation.
+ *
+ * \param environnement L'environnement.
+ * \param action Indice de la direction dans lesDirections, une autre valeur garde la direction.
+ * \return La récompense : RECOMPENSE_POMME, RECOMPENSE_MORT ou RECOMPENSE_PAS.
+ */
+float avancerEnvironnement(t_environnement *environnement, int action);
+
+/**
+ * \brief Joue une action dans chaque environnement d'un tableau.
+ *
+ * Un environnement dont l'épisode se termine passe aussitôt à l'épisode
+ * suivant : son observation est alors celle du début du nouvel épisode.
+ *
+ * \param environnements Les environnements.
+ * \param nombre Nombre d'environnements.
+ * \param actions Action de chaque environnement.
+ * \param recompenses Récompense de chaque environnement.
+ * \param termines true pour chaque environnement dont l'épisode vient de se terminer.
+ */
+void avancerEnvironnements(t_environnement *environnements, int nombre, const int *actions,
+                           float *recompenses, bool *termines);
+
+#endif
@@ -0,0 +1,97 @@
+/**
+* \file histogramme.c
+* \brief les histogrammes de durées à mémoire fixe
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+*/
+#include <string.h>
+
+#include "histogramme.h"
+
+#define DEMI_CASES (1 << (BITS_PRECISION - 1)) //constante pour le nombre de cases par puissance de deux
+
+/**
+ * \brief Donne la case d'une valeur.
+ * \param valeur La valeur, de 0 à DUREE_MAX.
+ * \return L'indice de la case.
+ */
+static int indiceValeur(uint64_t valeur){
+    // Le bit de poids fort, au moins celui des 2^BITS_PRECISION premières valeurs, fixe la largeur de la case
+    int decalage = 63 - __builtin_clzll(valeur | (2 * DEMI_CASES - 1)) - (BITS_PRECISION - 1);
+
+    return decalage * DEMI_CASES + (int)(valeur >> decalage);
+}
+
+/**
+ * \brief Donne la plus grande valeur d'une case.
+ * \param indice L'indice de la case.
+ * \return La valeur.
+ */
+static int64_t valeurCase(int indice){
+    int decalage = indice < 2 * DEMI_CASES ? 0 : indice / DEMI_CASES - 1;
+
+    return ((int64_t)(indice - decalage * DEMI_CASES) << decalage) + ((int64_t)1 << decalage) - 1;
+}
+
+void initHistogramme(t_histogramme *histogramme){
+    memset(histogramme->comptes, 0, sizeof(histogramme->comptes));
+    histogramme->nombre = 0;
+    histogramme->min = 0;
+    histogramme->max = 0;
+    histogramme->somme = 0;
+}
+
+void ajouterValeur(t_histogramme *histogramme, int64_t valeur){
+    if (valeur < 0) {
+        valeur = 0;
+    }
+    if (histogramme->nombre == 0 || valeur < histogramme->min) {
+        histogramme->min = valeur;
+    }
+    if (valeur > histogramme->max) {
+        histogramme->max = valeur;
+    }
+    histogramme->comptes[indiceValeur(valeur < DUREE_MAX ? (uint64_t)valeur : DUREE_MAX)]++;
+    histogramme->nombre++;
+    histogramme->somme += valeur;
+}
+
+int64_t centile(const t_histogramme *histogramme, double pourcentage){
+    uint64_t rang, cumul = 0;
+    int64_t valeur;
+    int i;
+
+    if (histogramme->nombre == 0) {
+        return 0;
+    }
+    // Rang de la valeur cherchée parmi les valeurs triées, à partir de 1
+    rang = (uint64_t)(pourcentage / 100.0 * histogramme->nombre + 0.5);
+    rang = rang < 1 ? 1 : rang > histogramme->nombre ? histogramme->nombre : rang;
+    for (i = 0; i < NB_CASES_HISTOGRAMME; i++) {
+        cumul += histogramme->comptes[i];
+        if (cumul >= rang) {
+            break;
+        }
+    }
+    valeur = valeurCase(i);
+    return valeur < histogramme->max ? valeur : histogramme->max;
+}
+
+bool ecrireHistogramme(FILE *fichier, const char *nom, const t_histogramme *histogramme){
+    uint64_t cumul = 0;
+    int i;
+
+    for (i = 0; i < NB_CASES_HISTOGRAMME; i++) {
+        if (histogramme->comptes[i] == 0) {
+            continue;
+        }
+        cumul += histogramme->comptes[i];
+        if (fprintf(fichier, "%s %lld %llu %.4f\n", nom, (long long)valeurCase(i),
+                    (unsigned long long)histogramme->comptes[i], cumul * 100.0 / histogramme->nombre) < 0) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,80 @@
+/**
+* \file histogramme.h
+* \brief les histogrammes de durées à mémoire fixe
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Un histogramme compte des durées en nanosecondes dans des cases de
+* largeur croissante, comme un histogramme HDR : les 2^BITS_PRECISION
+* premières valeurs ont chacune leur case, puis chaque puissance de deux
+* est découpée en 2^(BITS_PRECISION - 1) cases de même largeur. L'erreur
+* relative d'une valeur rendue reste donc sous 1 %, de la nanoseconde à
+* DUREE_MAX, sans aucune allocation pendant les mesures.
+*
+*/
+#ifndef HISTOGRAMME_H
+#define HISTOGRAMME_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+#define BITS_PRECISION 8 //constante pour le nombre de bits significatifs gardés d'une valeur
+#define BITS_DUREE 42 //constante pour le nombre de bits de la plus grande durée comptée (plus d'une heure)
+#define DUREE_MAX (((int64_t)1 << BITS_DUREE) - 1) //constante pour la plus grande durée comptée, en nanosecondes
+#define NB_CASES_HISTOGRAMME ((BITS_DUREE - BITS_PRECISION + 2) << (BITS_PRECISION - 1)) //constante pour le nombre de cases d'un histogramme
+
+/**
+ * \brief Histogramme de durées.
+ */
+typedef struct {
+    uint64_t comptes[NB_CASES_HISTOGRAMME]; // nombre de valeurs de chaque case
+    uint64_t nombre;                        // nombre de valeurs comptées
+    int64_t min;                            // plus petite valeur exacte
+    int64_t max;                            // plus grande valeur exacte
+    double somme;                           // somme des valeurs, pour la moyenne
+} t_histogramme;
+
+/**
+ * \brief Vide un histogramme.
+ * \param histogramme L'histogramme.
+ */
+void initHistogramme(t_histogramme *histogramme);
+
+/**
+ * \brief Compte une durée.
+ *
+ * Une durée négative compte pour 0, une durée au-delà de DUREE_MAX dans la dernière case.
+ *
+ * \param histogramme L'histogramme.
+ * \param valeur La durée en nanosecondes.
+ */
+void ajouterValeur(t_histogramme *histogramme, int64_t valeur);
+
+/**
+ * \brief Donne la valeur sous laquelle tombe un pourcentage des durées comptées.
+ *
+ * La valeur rendue est la plus grande de sa case, sans dépasser le maximum exact.
+ *
+ * \param histogramme L'histogramme.
+ * \param pourcentage Le pourcentage, de 0 à 100.
+ * \return La durée en nanosecondes, 0 si l'histogramme est vide.
+ */
+int64_t centile(const t_histogramme *histogramme, double pourcentage);
+
+/**
+ * \brief Écrit les cases non vides d'un histogramme, une par ligne.
+ *
+ * Chaque ligne donne le nom, la plus grande durée de la case en
+ * nanosecondes, le nombre de valeurs de la case et le pourcentage des
+ * valeurs comptées jusqu'à elle.
+ *
+ * \param fichier Le fichier.
+ * \param nom Nom de l'histogramme, sans espace.
+ * \param histogramme L'histogramme.
+ * \return false en cas d'erreur d'écriture.
+ */
+bool ecrireHistogramme(FILE *fichier, const char *nom, const t_histogramme *histogramme);
+
+#endif
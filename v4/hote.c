@@ -0,0 +1,788 @@
+/**
+* \file hote.c
+* \brief des parties de snake hébergées pour des joueurs connectés
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Un seul processus héberge une partie par joueur connecté à sa socket Unix,
+* au lieu d'un processus version4 par joueur. Les parties sont réparties
+* entre une boucle d'évènements par cœur, chacune dans son fil : un joueur
+* accepté par une boucle y reste jusqu'à sa déconnexion.
+*
+* Chaque boucle attend ses sockets avec epoll et fait avancer ses parties
+* avec une roue de minuteurs : NB_CRANS crans de RESOLUTION_ROUE
+* nanosecondes, la roue tournant d'un cran à chaque expiration d'un timerfd.
+* Une partie est rangée dans le cran de la date de son prochain tick,
+* qui suit sa propre vitesse (periodeTick()). Un tick a donc lieu au plus
+* un cran après sa date, quel que soit le nombre de parties.
+*
+* Le joueur envoie ses touches comme au clavier de version4 : une touche
+* est prise en compte par tick, PAUSE arrête la partie jusqu'à la touche
+* suivante autre que PAUSE et ARRET ferme la connexion. Il reçoit les messages de
+* diffusion.h : une image au début de chaque partie, puis un delta par tick.
+* Un joueur qui ne lit pas assez vite perd ses deltas en attente et reçoit
+* une nouvelle image, la boucle n'attend jamais. Une partie terminée est
+* aussitôt remplacée par une nouvelle.
+*
+* À l'arrêt (signal ou --duree), le nombre de ticks et le retard des ticks
+* sur leur date, la gigue, sont affichés pour chaque boucle.
+*
+* Avec --trace (programme compilé avec -DTRACE), les ticks, les attentes
+* de chaque boucle et les envois sont écrits à l'arrêt dans une trace de Chrome.
+*
+* Compilation : gcc -O2 -pthread -o hote hote.c moteur.c alea.c diffusion.c trace.c
+* Utilisation : ./hote [--socket chemin] [--fils nombre] [--duree secondes] [--graine graine]
+*                      [--paves nombre] [--taille-pave cote] [--largeur largeur] [--hauteur hauteur]
+*                      [--taille taille_serpent] [--objectif pommes] [--bits] [--trace fichier]
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <errno.h>
+#include <time.h>
+#include <signal.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/resource.h>
+
+#include "moteur.h"
+#include "diffusion.h"
+#include "trace.h"
+
+#define MAX_FILS 256 //constante pour le nombre maximum de boucles
+#define RESOLUTION_ROUE 1000000 //constante pour la durée d'un cran de la roue, en nanosecondes
+#define NB_CRANS 256 //constante pour le nombre de crans de la roue, une puissance de deux
+#define TAILLE_CLAVIER 64 //constante pour le nombre de touches en attente d'un joueur
+#define EVENEMENTS 256 //constante pour le nombre d'évènements lus par epoll_wait()
+#define SOCKET_HOTE "snake.sock" //constante pour le chemin de la socket par défaut
+#define ACCEPTATIONS 8 //constante pour le nombre maximum de joueurs acceptés par réveil d'une boucle
+
+/**
+ * \brief Un joueur connecté et sa partie.
+ *
+ * Les touches reçues attendent dans un tampon circulaire, une par tick.
+ */
+typedef struct s_session {
+    int fd;                        // socket du joueur
+    t_partie *partie;              // la partie du joueur
+    t_sortie sortie;               // messages en attente d'envoi
+    char touches[TAILLE_CLAVIER];  // touches reçues et pas encore jouées
+    unsigned debut;                // rang de la prochaine touche à jouer
+    unsigned fin;                  // rang de fin des touches en attente
+    char cle;                      // direction demandée
+    bool pause;                    // la partie attend la prochaine touche
+    bool resynchroniser;           // le joueur attend une image à la place des deltas
+    bool surveilleEcriture;        // epoll prévient quand la socket accepte à nouveau des octets
+    int64_t periode;               // durée d'un tick de la partie
+    int64_t echeance;              // date du prochain tick
+    int cran;                      // cran de la roue où la session est rangée, -1 si elle n'y est pas
+    struct s_session *suivante;    // session suivante du même cran
+    struct s_session *precedente;  // session précédente du même cran
+} t_session;
+
+/**
+ * \brief Une boucle d'évènements, son fil, sa roue de minuteurs et ses mesures.
+ */
+typedef struct {
+    pthread_t fil;               // le fil
+    int epoll;                   // instance epoll de la boucle
+    int minuteur;                // timerfd qui fait tourner la roue
+    t_session *roue[NB_CRANS];   // sessions rangées dans chaque cran
+    t_session *fermees;          // sessions fermées, libérées après la série d'évènements en cours
+    int64_t cran;                // dernier cran traité, compté depuis l'origine de l'horloge
+    uint8_t *image;              // tampon des images envoyées par la boucle
+    long sessions;               // sessions actuellement hébergées
+    long connexions;             // sessions acceptées depuis le début
+    long ticks;                  // ticks joués
+    long parties;                // parties terminées
+    long decrochages;            // joueurs trop lents renvoyés à une image
+    long octets;                 // octets envoyés
+    int64_t gigueTotale;         // somme des retards des ticks sur leur date, en nanosecondes
+    int64_t gigueMax;            // plus grand retard d'un tick, en nanosecondes
+} t_boucle;
+
+/**
+ * \brief Réglages et état partagés par toutes les boucles.
+ */
+typedef struct {
+    int ecoute;                  // socket d'écoute, surveillée par toutes les boucles
+    t_config config;             // réglages des parties
+    uint64_t graine;             // graine commune des parties
+    atomic_ulong flux;           // flux de la prochaine partie, chaque partie a le sien
+    t_boucle *boucles;           // les boucles
+    int nbBoucles;               // nombre de boucles
+    size_t tailleImage;          // taille maximale d'une image
+} t_hote;
+
+t_hote hote;
+volatile sig_atomic_t arret = 0;
+
+/**
+ * \brief Demande l'arrêt de toutes les boucles à la réception d'un signal.
+ * \param signal Le signal reçu.
+ */
+void signalArret(int signal);
+
+/**
+ * \brief Donne la date actuelle de l'horloge monotone.
+ * \return La date en nanosecondes.
+ */
+int64_t maintenant();
+
+/**
+ * \brief Range une session dans le cran de la roue qui contient la date de son prochain tick.
+ *
+ * Une date déjà passée est rangée dans le cran suivant.
+ *
+ * \param boucle La boucle.
+ * \param session La session, qui n'est dans aucun cran.
+ */
+void programmer(t_boucle *boucle, t_session *session);
+
+/**
+ * \brief Retire une session de son cran de la roue.
+ * \param boucle La boucle.
+ * \param session La session.
+ */
+void deprogrammer(t_boucle *boucle, t_session *session);
+
+/**
+ * \brief Ferme la connexion d'une session.
+ *
+ * La session n'est libérée qu'après la série d'évènements en cours,
+ * qui peut encore la désigner : son fd vaut alors -1.
+ *
+ * \param boucle La boucle.
+ * \param session La session.
+ */
+void fermerSession(t_boucle *boucle, t_session *session);
+
+/**
+ * \brief Libère les sessions fermées.
+ * \param boucle La boucle.
+ */
+void libererFermees(t_boucle *boucle);
+
+/**
+ * \brief Envoie les messages en attente d'une session et surveille sa socket tant qu'il en reste.
+ * \param boucle La boucle.
+ * \param session La session.
+ * \return false si le joueur est parti et la session a été fermée.
+ */
+bool envoyerSession(t_boucle *boucle, t_session *session);
+
+/**
+ * \brief Ajoute un message pour le joueur, ou une image s'il a pris trop de retard.
+ * \param boucle La boucle.
+ * \param session La session.
+ * \param octets Le message, NULL pour n'envoyer qu'une image attendue.
+ * \param taille Taille du message.
+ */
+void ajouterMessageSession(t_boucle *boucle, t_session *session, const uint8_t *octets, int taille);
+
+/**
+ * \brief Annonce par une image la partie qui commence dans une session.
+ *
+ * La partie est déjà créée ou réinitialisée, avec son propre flux.
+ *
+ * \param boucle La boucle.
+ * \param session La session.
+ */
+void nouvellePartieSession(t_boucle *boucle, t_session *session);
+
+/**
+ * \brief Accepte un joueur en attente de connexion, s'il y en a encore un.
+ * \param boucle La boucle.
+ * \return false s'il n'y avait plus de joueur en attente.
+ */
+bool accepterSession(t_boucle *boucle);
+
+/**
+ * \brief Lit les touches envoyées par un joueur.
+ * \param boucle La boucle.
+ * \param session La session.
+ */
+void lireTouches(t_boucle *boucle, t_session *session);
+
+/**
+ * \brief Termine la pause d'une session si une touche le permet, sans la reprogrammer.
+ *
+ * Comme dans version4, les PAUSE reçues pendant la pause sont ignorées ;
+ * la première autre touche la termine et compte si c'est une direction.
+ *
+ * \param session La session, en pause.
+ * \return true si la pause est terminée.
+ */
+bool terminerPause(t_session *session);
+
+/**
+ * \brief Joue un tick d'une session : une touche, une progression et son delta.
+ * \param boucle La boucle.
+ * \param session La session, retirée de la roue.
+ * \param date La date actuelle.
+ */
+void jouerTick(t_boucle *boucle, t_session *session, int64_t date);
+
+/**
+ * \brief Fait tourner la roue jusqu'à la date actuelle et joue les ticks dus.
+ * \param boucle La boucle.
+ */
+void tournerRoue(t_boucle *boucle);
+
+/**
+ * \brief Boucle d'évènements d'un fil, jusqu'à l'arrêt.
+ * \param argument La boucle.
+ * \return NULL.
+ */
+void *boucler(void *argument);
+
+/**
+ * \brief Prépare une boucle : instance epoll, timerfd et roue vide.
+ * \param boucle La boucle.
+ * \return false en cas d'erreur, déjà affichée.
+ */
+bool initBoucle(t_boucle *boucle);
+
+/**
+ * \brief Lit la valeur entière d'une option, ou arrête le programme avec un message qui nomme l'option.
+ * \param programme Nom du programme.
+ * \param option Nom de l'option.
+ * \param texte Valeur donnée à l'option.
+ * \param min Plus petite valeur acceptée.
+ * \param max Plus grande valeur acceptée.
+ * \return La valeur lue.
+ */
+int lireOption(const char *programme, const char *option, const char *texte, int min, int max);
+
+int main(int argc, char *argv[])
+{
+    struct sockaddr_un adresse = { .sun_family = AF_UNIX };
+    struct sigaction action;
+    struct rlimit limite;
+    const char *chemin = SOCKET_HOTE;
+    const char *erreur;
+    const char *cheminTrace = NULL;
+    long nbFils = sysconf(_SC_NPROCESSORS_ONLN);
+    double duree = 0;
+    int64_t debut, fin;
+    long sessions = 0, connexions = 0, ticks = 0, parties = 0, decrochages = 0, octets = 0;
+    int64_t gigueTotale = 0, gigueMax = 0;
+    t_boucle *boucle;
+    int i;
+
+    hote.config = configDefaut;
+    hote.graine = 1;
+    for (i = 1; i < argc; i++) { // Lecture des options
+        if (strcmp(argv[i], "--socket") == 0 && i + 1 < argc) {
+            chemin = argv[++i];
+        }
+        else if (strcmp(argv[i], "--fils") == 0 && i + 1 < argc) {
+            nbFils = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--duree") == 0 && i + 1 < argc) {
+            duree = atof(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--graine") == 0 && i + 1 < argc) {
+            if (!lireGraine(argv[++i], &hote.graine)) {
+                fprintf(stderr, "%s : --graine attend un entier entre 0 et %llu, pas « %s »\n", argv[0],
+                        (unsigned long long)UINT64_MAX, argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "--paves") == 0 && i + 1 < argc) {
+            hote.config.nbPaves = lireOption(argv[0], "--paves", argv[++i], 0, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--taille-pave") == 0 && i + 1 < argc) {
+            hote.config.taillePave = lireOption(argv[0], "--taille-pave", argv[++i], 0, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--largeur") == 0 && i + 1 < argc) {
+            hote.config.largeur = lireOption(argv[0], "--largeur", argv[++i], MINI_PLATEAU, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--hauteur") == 0 && i + 1 < argc) {
+            hote.config.hauteur = lireOption(argv[0], "--hauteur", argv[++i], MINI_PLATEAU, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--taille") == 0 && i + 1 < argc) {
+            hote.config.tailleSerpent = lireOption(argv[0], "--taille", argv[++i], 1, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--objectif") == 0 && i + 1 < argc) {
+            hote.config.objectif = lireOption(argv[0], "--objectif", argv[++i], 1, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--bits") == 0) {
+            hote.config.stockage = STOCKAGE_BITS;
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            cheminTrace = argv[++i];
+        }
+        else {
+            fprintf(stderr, "usage : %s [--socket chemin] [--fils nombre] [--duree secondes] [--graine graine]\n"
+                            "        %*s [--paves nombre] [--taille-pave cote] [--largeur largeur] [--hauteur hauteur]\n"
+                            "        %*s [--taille taille_serpent] [--objectif pommes] [--bits] [--trace fichier]\n",
+                    argv[0], (int)strlen(argv[0]), "", (int)strlen(argv[0]), "");
+            return EXIT_FAILURE;
+        }
+    }
+    erreur = erreurConfig(&hote.config);
+    if (erreur != NULL) {
+        fprintf(stderr, "%s : %s\n", argv[0], erreur);
+        return EXIT_FAILURE;
+    }
+    if (cheminTrace != NULL && !TRACE_ACTIVE) {
+        fprintf(stderr, "%s : --trace demande un programme compilé avec -DTRACE\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (nbFils < 1 || nbFils > MAX_FILS || strlen(chemin) >= sizeof(adresse.sun_path)) {
+        fprintf(stderr, "%s : il faut entre 1 et %d fils et un chemin de socket plus court\n", argv[0], MAX_FILS);
+        return EXIT_FAILURE;
+    }
+
+    // Une socket par joueur : autant de descripteurs que le système le permet
+    if (getrlimit(RLIMIT_NOFILE, &limite) == 0 && limite.rlim_cur < limite.rlim_max) {
+        limite.rlim_cur = limite.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &limite);
+    }
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = signalArret;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    strcpy(adresse.sun_path, chemin);
+    hote.ecoute = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    unlink(chemin);
+    if (hote.ecoute == -1 || bind(hote.ecoute, (struct sockaddr *)&adresse, sizeof(adresse)) == -1
+        || listen(hote.ecoute, SOMAXCONN) == -1) {
+        perror(chemin);
+        return EXIT_FAILURE;
+    }
+    { // La taille des images ne dépend que des réglages
+        t_partie *partie = partieCreer(&hote.config, hote.graine, 0);
+
+        if (partie == NULL) {
+            perror("partieCreer");
+            return EXIT_FAILURE;
+        }
+        hote.tailleImage = tailleMaxImage(partie);
+        partieDetruire(partie);
+    }
+
+    hote.nbBoucles = (int)nbFils;
+    hote.boucles = calloc(hote.nbBoucles, sizeof(t_boucle));
+    if (hote.boucles == NULL) {
+        perror("calloc");
+        return EXIT_FAILURE;
+    }
+    for (i = 0; i < hote.nbBoucles; i++) {
+        if (!initBoucle(&hote.boucles[i])) {
+            return EXIT_FAILURE;
+        }
+    }
+    debut = maintenant();
+    for (i = 0; i < hote.nbBoucles; i++) {
+        if (pthread_create(&hote.boucles[i].fil, NULL, boucler, &hote.boucles[i]) != 0) {
+            perror("pthread_create");
+            return EXIT_FAILURE;
+        }
+    }
+    printf("Hôte : %d boucles sur %s\n", hote.nbBoucles, chemin);
+    fflush(stdout);
+
+    fin = debut + (int64_t)(duree * 1e9);
+    while (!arret && (duree <= 0 || maintenant() < fin)) {
+        usleep(100000);
+    }
+    arret = 1;
+    for (i = 0; i < hote.nbBoucles; i++) {
+        pthread_join(hote.boucles[i].fil, NULL);
+    }
+    duree = (maintenant() - debut) / 1e9;
+    close(hote.ecoute);
+    unlink(chemin);
+    if (cheminTrace != NULL && !TRACE_ECRIRE(cheminTrace)) { // Les boucles sont terminées, leurs anneaux ne bougent plus
+        perror(cheminTrace);
+    }
+
+    for (i = 0; i < hote.nbBoucles; i++) {
+        boucle = &hote.boucles[i];
+        printf("Boucle %d : %ld sessions (%ld acceptées), %ld ticks, gigue moyenne %.1f µs, gigue max %.1f µs\n",
+               i, boucle->sessions, boucle->connexions, boucle->ticks,
+               boucle->ticks > 0 ? boucle->gigueTotale / 1000.0 / boucle->ticks : 0.0, boucle->gigueMax / 1000.0);
+        sessions += boucle->sessions;
+        connexions += boucle->connexions;
+        ticks += boucle->ticks;
+        parties += boucle->parties;
+        decrochages += boucle->decrochages;
+        octets += boucle->octets;
+        gigueTotale += boucle->gigueTotale;
+        gigueMax = boucle->gigueMax > gigueMax ? boucle->gigueMax : gigueMax;
+        free(boucle->image);
+    }
+    printf("Total : %ld sessions à l'arrêt, %ld acceptées, %ld ticks en %.1f s (%.0f ticks/s), %ld parties terminées\n",
+           sessions, connexions, ticks, duree, ticks / duree, parties);
+    printf("Gigue moyenne %.1f µs, gigue max %.1f µs, %ld décrochages, %.1f Mo envoyés\n",
+           ticks > 0 ? gigueTotale / 1000.0 / ticks : 0.0, gigueMax / 1000.0, decrochages, octets / 1048576.0);
+    free(hote.boucles);
+    return EXIT_SUCCESS;
+}
+
+void signalArret(int signal){
+    (void)signal;
+    arret = 1;
+}
+
+int64_t maintenant(){
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+void programmer(t_boucle *boucle, t_session *session){
+    // Le cran qui se termine à la date du tick ou juste après : un tick n'est jamais en avance
+    int64_t cran = (session->echeance + RESOLUTION_ROUE - 1) / RESOLUTION_ROUE;
+
+    if (cran <= boucle->cran) {
+        cran = boucle->cran + 1;
+    }
+    session->cran = (int)(cran & (NB_CRANS - 1));
+    session->precedente = NULL;
+    session->suivante = boucle->roue[session->cran];
+    if (session->suivante != NULL) {
+        session->suivante->precedente = session;
+    }
+    boucle->roue[session->cran] = session;
+}
+
+void deprogrammer(t_boucle *boucle, t_session *session){
+    if (session->cran < 0) {
+        return;
+    }
+    if (session->precedente != NULL) {
+        session->precedente->suivante = session->suivante;
+    }
+    else {
+        boucle->roue[session->cran] = session->suivante;
+    }
+    if (session->suivante != NULL) {
+        session->suivante->precedente = session->precedente;
+    }
+    session->cran = -1;
+}
+
+void fermerSession(t_boucle *boucle, t_session *session){
+    deprogrammer(boucle, session);
+    close(session->fd); // Retire aussi la socket de epoll
+    session->fd = -1;
+    session->suivante = boucle->fermees;
+    boucle->fermees = session;
+    boucle->sessions--;
+}
+
+void libererFermees(t_boucle *boucle){
+    t_session *session;
+
+    while (boucle->fermees != NULL) {
+        session = boucle->fermees;
+        boucle->fermees = session->suivante;
+        libererSortie(&session->sortie);
+        partieDetruire(session->partie);
+        free(session);
+    }
+}
+
+bool envoyerSession(t_boucle *boucle, t_session *session){
+    struct epoll_event evenement;
+    bool surveiller;
+
+    if (!envoyerSortie(&session->sortie, session->fd, &boucle->octets)) {
+        fermerSession(boucle, session);
+        return false;
+    }
+    surveiller = attenteSortie(&session->sortie) > 0;
+    if (session->surveilleEcriture != surveiller) {
+        evenement.events = EPOLLIN | (surveiller ? EPOLLOUT : 0);
+        evenement.data.ptr = session;
+        epoll_ctl(boucle->epoll, EPOLL_CTL_MOD, session->fd, &evenement);
+        session->surveilleEcriture = surveiller;
+    }
+    return true;
+}
+
+void ajouterMessageSession(t_boucle *boucle, t_session *session, const uint8_t *octets, int taille){
+    // Trop en retard : les deltas en attente sont abandonnés, une image en cours d'envoi ne compte pas
+    if (octets != NULL && !session->resynchroniser
+        && attenteSortie(&session->sortie) + taille > RETARD_MAX + (int)hote.tailleImage) {
+        abandonnerSortie(&session->sortie);
+        session->resynchroniser = true;
+        boucle->decrochages++;
+    }
+    if (session->resynchroniser) { // L'image remplace le message
+        if (ajouterSortie(&session->sortie, boucle->image, ecrireImage(boucle->image, session->partie))) {
+            session->resynchroniser = false;
+        }
+    }
+    else {
+        ajouterSortie(&session->sortie, octets, taille);
+    }
+}
+
+void nouvellePartieSession(t_boucle *boucle, t_session *session){
+    session->cle = DROITE;
+    session->periode = periodeTick(0);
+    session->resynchroniser = true;
+    ajouterMessageSession(boucle, session, NULL, 0);
+}
+
+bool accepterSession(t_boucle *boucle){
+    struct epoll_event evenement;
+    t_session *session;
+    int fd;
+
+    fd = accept(hote.ecoute, NULL, NULL);
+    if (fd == -1) {
+        return false; // Pris par une autre boucle, ou trop de descripteurs
+    }
+    session = calloc(1, sizeof(t_session));
+    if (session == NULL) {
+        close(fd);
+        return true;
+    }
+    session->fd = fd;
+    session->cran = -1;
+    // Créée directement avec son flux : construire le plateau coûte des dizaines de µs
+    session->partie = partieCreer(&hote.config, hote.graine, atomic_fetch_add(&hote.flux, 1));
+    if (session->partie == NULL) {
+        free(session);
+        close(fd);
+        return true;
+    }
+    evenement.events = EPOLLIN;
+    evenement.data.ptr = session;
+    if (!initSortie(&session->sortie, RETARD_MAX + 2 * ((int)hote.tailleImage + TAILLE_DELTA))
+        || fcntl(fd, F_SETFL, O_NONBLOCK) == -1 || epoll_ctl(boucle->epoll, EPOLL_CTL_ADD, fd, &evenement) == -1) {
+        libererSortie(&session->sortie);
+        partieDetruire(session->partie);
+        free(session);
+        close(fd);
+        return true;
+    }
+    boucle->sessions++;
+    boucle->connexions++;
+    nouvellePartieSession(boucle, session);
+    if (envoyerSession(boucle, session)) {
+        session->echeance = maintenant() + session->periode;
+        programmer(boucle, session);
+    }
+    return true;
+}
+
+void lireTouches(t_boucle *boucle, t_session *session){
+    char recues[TAILLE_CLAVIER];
+    ssize_t n, i;
+
+    n = recv(session->fd, recues, sizeof(recues), 0);
+    TRACE_INSTANT("touches lues", n);
+    if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+        return;
+    }
+    if (n <= 0) { // Le joueur est parti
+        fermerSession(boucle, session);
+        return;
+    }
+    for (i = 0; i < n; i++) {
+        if (recues[i] == ARRET) {
+            fermerSession(boucle, session);
+            return;
+        }
+        if (session->fin - session->debut < TAILLE_CLAVIER) { // Un clavier plein perd les touches suivantes
+            session->touches[session->fin++ % TAILLE_CLAVIER] = recues[i];
+        }
+    }
+    if (session->pause && terminerPause(session)) {
+        deprogrammer(boucle, session);
+        session->echeance = maintenant() + session->periode;
+        programmer(boucle, session);
+    }
+}
+
+bool terminerPause(t_session *session){
+    while (session->debut != session->fin && session->touches[session->debut % TAILLE_CLAVIER] == PAUSE) {
+        session->debut++;
+    }
+    session->pause = session->debut == session->fin;
+    return !session->pause;
+}
+
+void jouerTick(t_boucle *boucle, t_session *session, int64_t date){
+    uint8_t delta[TAILLE_DELTA];
+    t_resultat resultat;
+    int64_t retard = date - session->echeance;
+    char touche;
+
+    if (session->pause) { // La session reste dans la roue sans jouer, jusqu'à la prochaine touche
+        terminerPause(session); // Une touche reçue avec la PAUSE la termine déjà
+        session->echeance += session->periode;
+        programmer(boucle, session);
+        return;
+    }
+    boucle->ticks++;
+    boucle->gigueTotale += retard;
+    if (retard > boucle->gigueMax) {
+        boucle->gigueMax = retard;
+    }
+
+    if (session->debut != session->fin) { // Une touche par tick, comme au clavier
+        touche = session->touches[session->debut++ % TAILLE_CLAVIER];
+        if (touche == PAUSE) {
+            session->pause = true;
+            session->echeance += session->periode;
+            programmer(boucle, session);
+            return;
+        }
+        session->cle = touche;
+    }
+    resultat = avancerPartie(session->partie, session->cle);
+    ajouterMessageSession(boucle, session, delta, ecrireDelta(delta, session->partie, &resultat));
+    if (resultat.collision || resultat.gagne) {
+        boucle->parties++;
+        reinitialiserPartie(session->partie, hote.graine, atomic_fetch_add(&hote.flux, 1));
+        nouvellePartieSession(boucle, session);
+    }
+    else if (resultat.pomme) {
+        session->periode = periodeTick(session->partie->pommeMange);
+    }
+    if (!envoyerSession(boucle, session)) {
+        return;
+    }
+
+    // Les dates restent absolues : le retard d'un tick ne décale pas les suivants
+    session->echeance += session->periode;
+    programmer(boucle, session);
+}
+
+void tournerRoue(t_boucle *boucle){
+    int64_t date = maintenant();
+    int64_t dernier = date / RESOLUTION_ROUE;
+    t_session *session, *suivante;
+    int64_t cran;
+
+    // Après un retard de plus d'un tour, chaque cran n'est traité qu'une fois
+    if (dernier - boucle->cran > NB_CRANS) {
+        boucle->cran = dernier - NB_CRANS;
+    }
+    for (cran = boucle->cran + 1; cran <= dernier; cran++) {
+        session = boucle->roue[cran & (NB_CRANS - 1)];
+        boucle->roue[cran & (NB_CRANS - 1)] = NULL;
+        boucle->cran = cran; // Les sessions reprogrammées vont dans les crans suivants
+        while (session != NULL) {
+            suivante = session->suivante;
+            session->cran = -1;
+            if (session->echeance <= date) { // Le retard est mesuré au moment où ce tick est joué
+                TRACE_DEBUT("tick");
+                jouerTick(boucle, session, maintenant());
+                TRACE_FIN("tick", boucle->ticks);
+            }
+            else { // Un tour de roue ou plus avant son tick
+                programmer(boucle, session);
+            }
+            session = suivante;
+        }
+    }
+}
+
+void *boucler(void *argument){
+    t_boucle *boucle = argument;
+    struct epoll_event evenements[EVENEMENTS];
+    t_session *session;
+    uint64_t expirations;
+    int n, i, k;
+
+    while (!arret) {
+        TRACE_DEBUT("attente");
+        n = epoll_wait(boucle->epoll, evenements, EVENEMENTS, -1); // Le timerfd réveille la boucle à chaque cran
+        TRACE_FIN("attente", n);
+        for (i = 0; i < n; i++) {
+            if (evenements[i].data.ptr == &hote) { // Quelques joueurs à la fois, pour ne pas retarder les ticks
+                TRACE_DEBUT("acceptations");
+                for (k = 0; k < ACCEPTATIONS && accepterSession(boucle); k++) {
+                }
+                TRACE_FIN("acceptations", k);
+            }
+            else if (evenements[i].data.ptr == &boucle->minuteur) {
+                if (read(boucle->minuteur, &expirations, sizeof(expirations)) > 0) {
+                    tournerRoue(boucle);
+                }
+            }
+            else {
+                session = evenements[i].data.ptr;
+                if (session->fd < 0) { // Fermée plus tôt dans la même série
+                    continue;
+                }
+                if (evenements[i].events & (EPOLLOUT | EPOLLERR | EPOLLHUP)) {
+                    if (!envoyerSession(boucle, session)) {
+                        continue;
+                    }
+                }
+                if (evenements[i].events & EPOLLIN) {
+                    lireTouches(boucle, session);
+                }
+            }
+        }
+        libererFermees(boucle);
+    }
+
+    for (i = 0; i < NB_CRANS; i++) { // Toutes les sessions sont dans la roue, en pause comprises
+        while (boucle->roue[i] != NULL) {
+            fermerSession(boucle, boucle->roue[i]);
+        }
+    }
+    libererFermees(boucle);
+    close(boucle->minuteur);
+    close(boucle->epoll);
+    return NULL;
+}
+
+bool initBoucle(t_boucle *boucle){
+    struct epoll_event ecoute = { .events = EPOLLIN | EPOLLEXCLUSIVE, .data.ptr = &hote };
+    struct epoll_event minuteur = { .events = EPOLLIN, .data.ptr = &boucle->minuteur };
+    struct itimerspec periode = { .it_interval = { 0, RESOLUTION_ROUE } };
+    int64_t depart;
+
+    boucle->image = malloc(hote.tailleImage);
+    boucle->epoll = epoll_create1(EPOLL_CLOEXEC);
+    boucle->minuteur = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    // Les crans commencent aux multiples de RESOLUTION_ROUE de l'horloge monotone
+    depart = (maintenant() / RESOLUTION_ROUE + 1) * RESOLUTION_ROUE;
+    periode.it_value.tv_sec = depart / 1000000000;
+    periode.it_value.tv_nsec = depart % 1000000000;
+    boucle->cran = depart / RESOLUTION_ROUE - 1;
+    // Une seule boucle est réveillée par connexion : les joueurs se répartissent entre les boucles
+    if (boucle->image == NULL || boucle->epoll == -1 || boucle->minuteur == -1
+        || timerfd_settime(boucle->minuteur, TFD_TIMER_ABSTIME, &periode, NULL) == -1
+        || epoll_ctl(boucle->epoll, EPOLL_CTL_ADD, hote.ecoute, &ecoute) == -1
+        || epoll_ctl(boucle->epoll, EPOLL_CTL_ADD, boucle->minuteur, &minuteur) == -1) {
+        perror("initBoucle");
+        return false;
+    }
+    return true;
+}
+
+int lireOption(const char *programme, const char *option, const char *texte, int min, int max){
+    int valeur;
+
+    if (!lireEntier(texte, min, max, &valeur)) {
+        fprintf(stderr, "%s : %s attend un entier entre %d et %d, pas « %s »\n", programme, option, min, max, texte);
+        exit(EXIT_FAILURE);
+    }
+    return valeur;
+}
@@ -0,0 +1,204 @@
+/**
+* \file journal.c
+* \brief l'enregistrement et la relecture des parties du jeu snake
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+*/
+#include <stdio.h>
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "journal.h"
+
+#define NB_CODES 6 //constante pour le nombre de touches ayant un code
+#define BITS_CODE 3 //constante pour le nombre de bits du code d'une touche
+#define NB_REGLAGES 6 //constante pour le nombre de réglages de t_config écrits dans le journal
+
+static const char codes[NB_CODES] = { HAUT, BAS, GAUCHE, DROITE, ARRET, PAUSE };
+
+/**
+ * \brief Écrit un entier en varint.
+ * \param fichier Le fichier.
+ * \param valeur L'entier.
+ */
+static void ecrireVarint(FILE *fichier, uint64_t valeur){
+    while (valeur >= 0x80) {
+        fputc((int)(valeur & 0x7f) | 0x80, fichier);
+        valeur >>= 7;
+    }
+    fputc((int)valeur, fichier);
+}
+
+/**
+ * \brief Lit un entier en varint dans le journal.
+ * \param lecteur Le journal.
+ * \param valeur L'entier lu.
+ * \return false si le journal se termine avant la fin de l'entier.
+ */
+static bool lireVarint(t_lecteur *lecteur, uint64_t *valeur){
+    int decalage = 0;
+    uint8_t octet;
+
+    *valeur = 0;
+    do {
+        if (lecteur->position == lecteur->taille || decalage > 63) {
+            return false;
+        }
+        octet = lecteur->octets[lecteur->position++];
+        *valeur |= (uint64_t)(octet & 0x7f) << decalage;
+        decalage += 7;
+    } while (octet & 0x80);
+    return true;
+}
+
+/**
+ * \brief Lit la touche suivante du journal, ou le marque comme fini.
+ * \param lecteur Le journal.
+ */
+static void avancerLecture(t_lecteur *lecteur){
+    uint64_t valeur, code;
+
+    if (!lireVarint(lecteur, &valeur)) {
+        lecteur->fini = true;
+        return;
+    }
+    code = valeur & ((1 << BITS_CODE) - 1);
+    lecteur->prochainTick += (long)(valeur >> BITS_CODE);
+    lecteur->prochaineTouche = code < NB_CODES ? codes[code] : AUTRE_TOUCHE;
+}
+
+bool ouvrirEnregistrement(t_enregistreur *enregistreur, const char *chemin, uint64_t graine, uint64_t flux,
+                          int64_t periodeFixe, const t_config *config){
+    enregistreur->fichier = fopen(chemin, "wb");
+    if (enregistreur->fichier == NULL) {
+        perror(chemin);
+        return false;
+    }
+    enregistreur->dernierTick = 0;
+    fwrite("SNK2", 1, 4, enregistreur->fichier);
+    ecrireVarint(enregistreur->fichier, graine);
+    ecrireVarint(enregistreur->fichier, flux);
+    ecrireVarint(enregistreur->fichier, (uint64_t)periodeFixe);
+    ecrireVarint(enregistreur->fichier, NB_REGLAGES);
+    ecrireVarint(enregistreur->fichier, (uint64_t)config->nbPaves);
+    ecrireVarint(enregistreur->fichier, (uint64_t)config->taillePave);
+    ecrireVarint(enregistreur->fichier, (uint64_t)config->largeur);
+    ecrireVarint(enregistreur->fichier, (uint64_t)config->hauteur);
+    ecrireVarint(enregistreur->fichier, (uint64_t)config->tailleSerpent);
+    ecrireVarint(enregistreur->fichier, (uint64_t)config->objectif);
+    if (ferror(enregistreur->fichier)) {
+        perror(chemin);
+        fclose(enregistreur->fichier);
+        return false;
+    }
+    return true;
+}
+
+void enregistrerTouche(t_enregistreur *enregistreur, long tick, char touche){
+    uint64_t code = NB_CODES;
+    int i;
+
+    for (i = 0; i < NB_CODES; i++) {
+        if (codes[i] == touche) {
+            code = i;
+        }
+    }
+    ecrireVarint(enregistreur->fichier, (uint64_t)(tick - enregistreur->dernierTick) << BITS_CODE | code);
+    enregistreur->dernierTick = tick;
+}
+
+bool fermerEnregistrement(t_enregistreur *enregistreur){
+    bool ok = !ferror(enregistreur->fichier);
+
+    if (fclose(enregistreur->fichier) != 0) { // Les dernières touches ne sont écrites qu'ici
+        ok = false;
+    }
+    enregistreur->fichier = NULL;
+    return ok;
+}
+
+bool ouvrirLecture(t_lecteur *lecteur, const char *chemin){
+    struct stat etat;
+    uint64_t periode, nbReglages, reglage;
+    uint64_t i;
+    void *projection;
+    int fd;
+
+    fd = open(chemin, O_RDONLY);
+    if (fd < 0) {
+        perror(chemin);
+        return false;
+    }
+    if (fstat(fd, &etat) < 0 || etat.st_size < 4) {
+        fprintf(stderr, "%s : journal vide ou illisible\n", chemin);
+        close(fd);
+        return false;
+    }
+    projection = mmap(NULL, etat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // La projection reste valide après la fermeture du descripteur
+    if (projection == MAP_FAILED) {
+        perror("mmap");
+        return false;
+    }
+    madvise(projection, etat.st_size, MADV_SEQUENTIAL);
+
+    lecteur->octets = projection;
+    lecteur->taille = etat.st_size;
+    lecteur->position = 4;
+    lecteur->fini = false;
+    lecteur->prochainTick = 0;
+    lecteur->config = configDefaut;
+    if ((memcmp(lecteur->octets, "SNK1", 4) != 0 && memcmp(lecteur->octets, "SNK2", 4) != 0) ||
+        !lireVarint(lecteur, &lecteur->graine) || !lireVarint(lecteur, &lecteur->flux) ||
+        !lireVarint(lecteur, &periode)) {
+        fprintf(stderr, "%s : ce n'est pas un journal de partie\n", chemin);
+        fermerLecture(lecteur);
+        return false;
+    }
+    lecteur->periodeFixe = (int64_t)periode;
+    if (lecteur->octets[3] == '2') { // Les réglages de la partie, dans l'ordre de t_config
+        int *reglages[NB_REGLAGES] = {
+            &lecteur->config.nbPaves, &lecteur->config.taillePave,
+            &lecteur->config.largeur, &lecteur->config.hauteur,
+            &lecteur->config.tailleSerpent, &lecteur->config.objectif
+        };
+
+        if (!lireVarint(lecteur, &nbReglages)) {
+            nbReglages = 0;
+        }
+        for (i = 0; i < nbReglages && lireVarint(lecteur, &reglage); i++) {
+            if (i < NB_REGLAGES) { // Les réglages inconnus d'une version plus récente sont sautés
+                *reglages[i] = (int)reglage;
+            }
+        }
+    }
+    lecteur->debut = lecteur->position;
+    avancerLecture(lecteur);
+    return true;
+}
+
+bool toucheRejouee(t_lecteur *lecteur, long tick, char *touche){
+    if (lecteur->fini || lecteur->prochainTick > tick) {
+        return false;
+    }
+    *touche = lecteur->prochaineTouche;
+    avancerLecture(lecteur);
+    return true;
+}
+
+void rembobinerLecture(t_lecteur *lecteur){
+    lecteur->position = lecteur->debut;
+    lecteur->fini = false;
+    lecteur->prochainTick = 0;
+    avancerLecture(lecteur);
+}
+
+void fermerLecture(t_lecteur *lecteur){
+    munmap((void *)lecteur->octets, lecteur->taille);
+    lecteur->octets = NULL;
+}
@@ -0,0 +1,125 @@
+/**
+* \file journal.h
+* \brief l'enregistrement et la relecture des parties du jeu snake
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Un journal contient la graine de la partie puis les touches appuyées,
+* chacune avec le tick où elle a été prise en compte. Le moteur étant
+* déterministe, ces données suffisent pour rejouer la partie à l'identique.
+*
+* Format du fichier, tous les entiers étant codés en varint
+* (7 bits par octet, bit de poids fort à 1 s'il reste des octets) :
+*   - les 4 octets "SNK2" ;
+*   - la graine, le flux et la durée imposée d'un tick en nanoseconde (0 si variable) ;
+*   - le nombre de réglages puis les réglages de la partie dans l'ordre de t_config,
+*     un réglage absent gardant sa valeur par défaut et un réglage inconnu étant ignoré ;
+*   - un entier par touche : (ticks écoulés depuis la touche précédente << 3) | code,
+*     le code étant l'indice de la touche dans HAUT, BAS, GAUCHE, DROITE, ARRET,
+*     PAUSE, ou 6 pour une autre touche.
+* Une touche appuyée moins de 16 ticks après la précédente tient donc dans un octet.
+* Les journaux "SNK1", sans réglages, sont toujours relus avec les réglages par défaut.
+*
+*/
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "moteur.h"
+
+#define AUTRE_TOUCHE ' ' //constante pour la touche rejouée à la place d'une touche sans effet
+
+/**
+ * \brief Journal en cours d'écriture.
+ */
+typedef struct {
+    FILE *fichier;   // fichier du journal
+    long dernierTick; // tick de la dernière touche enregistrée
+} t_enregistreur;
+
+/**
+ * \brief Journal en cours de relecture, projeté en mémoire.
+ */
+typedef struct {
+    const uint8_t *octets; // contenu du fichier
+    size_t taille;         // taille du fichier en octets
+    size_t debut;          // position de la première touche dans le contenu
+    size_t position;       // position de la prochaine touche dans le contenu
+    bool fini;             // toutes les touches ont été rejouées
+    long prochainTick;     // tick de la prochaine touche
+    char prochaineTouche;  // prochaine touche
+    uint64_t graine;       // graine de la partie
+    uint64_t flux;         // flux du générateur de la partie
+    int64_t periodeFixe;   // durée imposée d'un tick, 0 si elle variait avec les pommes
+    t_config config;       // réglages de la partie
+} t_lecteur;
+
+/**
+ * \brief Crée un journal et écrit son en-tête.
+ * \param enregistreur Le journal.
+ * \param chemin Chemin du fichier.
+ * \param graine Graine de la partie.
+ * \param flux Flux du générateur de la partie.
+ * \param periodeFixe Durée imposée d'un tick en nanosecondes, 0 si elle varie.
+ * \param config Réglages de la partie.
+ * \return false si le fichier ne peut pas être créé ou écrit, erreur déjà affichée.
+ */
+bool ouvrirEnregistrement(t_enregistreur *enregistreur, const char *chemin, uint64_t graine, uint64_t flux,
+                          int64_t periodeFixe, const t_config *config);
+
+/**
+ * \brief Ajoute une touche au journal.
+ * \param enregistreur Le journal.
+ * \param tick Tick où la touche est prise en compte, jamais inférieur à celui de la touche précédente.
+ * \param touche La touche.
+ *
+ * Une erreur d'écriture n'est connue qu'à la fermeture du journal.
+ */
+void enregistrerTouche(t_enregistreur *enregistreur, long tick, char touche);
+
+/**
+ * \brief Termine l'écriture du journal.
+ * \param enregistreur Le journal.
+ * \return false si une écriture du journal a échoué (errno indique pourquoi) : le journal est alors incomplet.
+ */
+bool fermerEnregistrement(t_enregistreur *enregistreur);
+
+/**
+ * \brief Ouvre un journal, le projette en mémoire et lit son en-tête.
+ * \param lecteur Le journal.
+ * \param chemin Chemin du fichier.
+ * \return false si le fichier ne peut pas être lu ou n'est pas un journal.
+ */
+bool ouvrirLecture(t_lecteur *lecteur, const char *chemin);
+
+/**
+ * \brief Donne la prochaine touche du journal si elle doit être prise en compte à ce tick.
+ *
+ * Plusieurs touches pouvant tomber sur le même tick, la fonction est
+ * appelée jusqu'à ce qu'elle renvoie false.
+ *
+ * \param lecteur Le journal.
+ * \param tick Le tick actuel.
+ * \param touche La touche rejouée.
+ * \return true si une touche est rejouée à ce tick.
+ */
+bool toucheRejouee(t_lecteur *lecteur, long tick, char *touche);
+
+/**
+ * \brief Revient à la première touche du journal, pour rejouer la partie une nouvelle fois.
+ * \param lecteur Le journal.
+ */
+void rembobinerLecture(t_lecteur *lecteur);
+
+/**
+ * \brief Libère la projection en mémoire du journal.
+ * \param lecteur Le journal.
+ */
+void fermerLecture(t_lecteur *lecteur);
+
+#endif
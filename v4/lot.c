@@ -0,0 +1,599 @@
+/**
+* \file lot.c
+* \brief parties de snake simulées en lot sur tous les cœurs
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Joue un grand nombre de parties sans terminal pour régler le jeu
+* (nombre et taille des pavés, nombre de pommes, taille du plateau).
+* Le serpent est dirigé par un joueur automatique simple : il va vers
+* la pomme en évitant les cases bloquées voisines de la tête. Avec --auto,
+* il est dirigé par le pilote automatique (autopilote.c), qui cherche un
+* chemin complet vers la pomme à chaque tick, et la durée de ses décisions
+* est affichée.
+*
+* La partie numéro i utilise la graine commune et le flux i, son joueur
+* utilise le flux i + FLUX_JOUEUR : les résultats ne dépendent pas du
+* nombre de fils ni de l'ordre dans lequel les parties sont jouées.
+*
+* Chaque fil garde sa propre partie et reçoit au départ une plage de
+* numéros de parties. Un fil qui a fini sa plage vole la moitié de la
+* plage restante d'un autre fil.
+*
+* Fichier de résultats, en colonnes, entiers dans l'ordre des octets de la machine :
+*   - les 4 octets "SNKL" ;
+*   - le nombre de parties et le nombre de colonnes (uint32_t) ;
+*   - la graine (uint64_t) puis les réglages dans l'ordre de t_config (int32_t)
+*     et la limite de ticks (uint32_t) ;
+*   - pour chaque colonne, son nom sur 16 octets complétés par des zéros
+*     et la taille d'une valeur en octets (uint32_t) ;
+*   - les valeurs de chaque colonne, les unes après les autres, pour toutes les parties :
+*     ticks (uint32_t), pommes (uint32_t) et fin (uint8_t, voir FIN_LIMITE).
+*
+* Compilation : gcc -O2 -pthread -o lot lot.c moteur.c alea.c autopilote.c
+* Utilisation : ./lot [--parties nombre] [--fils nombre] [--graine graine] [--sortie fichier]
+*                     [--ticks limite] [--paves nombre] [--taille-pave cote] [--largeur largeur]
+*                     [--hauteur hauteur] [--taille taille_serpent] [--objectif pommes] [--bits]
+*                     [--auto]
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "moteur.h"
+#include "alea.h"
+#include "autopilote.h"
+
+#define NB_PARTIES 10000 //constante pour le nombre de parties par défaut
+#define TICKS_MAX 100000 //constante pour le nombre maximum de ticks d'une partie, par défaut
+#define MAX_FILS 256 //constante pour le nombre maximum de fils
+#define FLUX_JOUEUR ((uint64_t)1 << 62) //constante ajoutée au flux d'une partie pour le générateur de son joueur
+#define NB_COLONNES 3 //constante pour le nombre de colonnes du fichier de résultats
+#define TAILLE_NOM 16 //constante pour la taille du nom d'une colonne dans le fichier
+#define FIN_LIMITE MORT_AUCUNE //constante pour une partie arrêtée à la limite de ticks
+#define FIN_MUR MORT_MUR //constante pour une partie perdue contre une bordure ou un pavé
+#define FIN_SERPENT MORT_SERPENT //constante pour une partie perdue contre le serpent
+#define FIN_GAGNEE 3 //constante pour une partie gagnée
+
+/**
+ * \brief Un fil de calcul et sa plage de parties.
+ *
+ * La plage tient dans un seul mot, (début << 32) | fin, pour que le fil
+ * et les voleurs la modifient par compare-and-swap sans verrou.
+ * Chaque fil occupe sa propre ligne de cache.
+ */
+typedef struct {
+    _Alignas(LIGNE_CACHE) _Atomic uint64_t plage; // numéros des parties restant à jouer
+    pthread_t fil;    // le fil
+    int numero;       // rang du fil
+    long parties;     // nombre de parties jouées par ce fil
+    long vols;        // nombre de plages volées par ce fil
+    t_autopilote *pilote;     // pilote automatique du fil, NULL sans --auto
+    long decisions;           // nombre de décisions du pilote
+    int64_t dureeDecisions;   // durée totale des décisions du pilote, en nanosecondes
+    int64_t dureeMaxDecision; // plus longue décision du pilote, en nanosecondes
+} t_ouvrier;
+
+/**
+ * \brief Réglages et résultats du lot, partagés par tous les fils.
+ *
+ * Chaque partie écrit ses résultats à son propre rang dans les colonnes.
+ */
+typedef struct {
+    t_config config;      // réglages des parties
+    uint64_t graine;      // graine commune des parties
+    uint32_t nbParties;   // nombre de parties du lot
+    uint32_t ticksMax;    // nombre maximum de ticks d'une partie
+    uint32_t *ticks;      // colonne des ticks joués
+    uint32_t *pommes;     // colonne des pommes mangées
+    uint8_t *fins;        // colonne des fins de partie
+    t_ouvrier *ouvriers;  // les fils
+    int nbOuvriers;       // nombre de fils
+    bool automatique;     // les serpents sont dirigés par le pilote automatique
+} t_lot;
+
+t_lot lot;
+
+/**
+ * \brief Donne la date actuelle de l'horloge monotone.
+ * \return La date en nanosecondes.
+ */
+int64_t maintenant();
+
+/**
+ * \brief Retire la prochaine partie de la plage d'un fil.
+ * \param ouvrier Le fil.
+ * \param partie Numéro de la partie retirée.
+ * \return false si la plage est vide.
+ */
+bool prendrePartie(t_ouvrier *ouvrier, uint32_t *partie);
+
+/**
+ * \brief Vole la seconde moitié de la plage d'un autre fil.
+ *
+ * Les autres fils sont essayés à tour de rôle à partir du suivant.
+ *
+ * \param ouvrier Le fil qui vole, dont la plage est vide.
+ * \return false si aucun fil n'a au moins deux parties à céder.
+ */
+bool volerParties(t_ouvrier *ouvrier);
+
+/**
+ * \brief Choisit la direction du joueur automatique.
+ *
+ * Parmi les directions qui ne mènent ni dans un mur ni dans le serpent,
+ * celles qui rapprochent la tête de la pomme sont préférées, et une est
+ * tirée au hasard parmi les meilleures. Sans direction sûre, le serpent
+ * continue tout droit.
+ *
+ * \param partie La partie.
+ * \param alea Générateur du joueur.
+ * \return La direction.
+ */
+char choisirDirection(const t_partie *partie, t_alea *alea);
+
+/**
+ * \brief Choisit la direction avec le pilote du fil s'il en a un, sinon avec choisirDirection().
+ * \param ouvrier Le fil.
+ * \param partie La partie.
+ * \param alea Générateur du joueur.
+ * \return La direction.
+ */
+char directionJoueur(t_ouvrier *ouvrier, const t_partie *partie, t_alea *alea);
+
+/**
+ * \brief Crée le pilote automatique d'un fil si le lot en utilise un.
+ * \param ouvrier Le fil.
+ * \param partie Une partie du fil, qui donne la taille du plateau.
+ */
+void preparerPilote(t_ouvrier *ouvrier, const t_partie *partie);
+
+/**
+ * \brief Retient les mesures du pilote d'un fil puis le libère.
+ * \param ouvrier Le fil.
+ */
+void rendrePilote(t_ouvrier *ouvrier);
+
+/**
+ * \brief Joue une partie du lot et range ses résultats.
+ * \param ouvrier Le fil qui joue la partie.
+ * \param partie La partie du fil, réinitialisée pour ce numéro.
+ * \param numero Numéro de la partie.
+ */
+void jouerPartie(t_ouvrier *ouvrier, t_partie *partie, uint32_t numero);
+
+/**
+ * \brief Range les résultats d'une partie terminée.
+ * \param numero Numéro de la partie.
+ * \param tick Nombre de ticks joués.
+ * \param pommes Nombre de pommes mangées.
+ * \param fin Cause de la fin de partie.
+ */
+void rangerResultats(uint32_t numero, uint32_t tick, int pommes, uint8_t fin);
+
+/**
+ * \brief Donne la cause de la fin d'une partie après un tick.
+ * \param resultat Le résultat du tick.
+ * \param tick Nombre de ticks joués, tick compris.
+ * \param fin Cause de la fin de partie, si elle est terminée.
+ * \return true si la partie est terminée.
+ */
+bool partieFinie(const t_resultat *resultat, uint32_t tick, uint8_t *fin);
+
+/**
+ * \brief Joue des parties jusqu'à ce qu'il n'en reste plus à prendre ni à voler.
+ * \param argument Le t_ouvrier du fil.
+ * \return NULL.
+ */
+void *travailler(void *argument);
+
+/**
+ * \brief Répartit les parties entre les fils, les lance et attend qu'ils aient fini.
+ * \return La durée du lot en nanosecondes.
+ */
+int64_t lancerLot();
+
+/**
+ * \brief Écrit le fichier de résultats en colonnes.
+ * \param chemin Chemin du fichier.
+ * \return false en cas d'erreur d'écriture, déjà affichée.
+ */
+bool ecrireResultats(const char *chemin);
+
+/**
+ * \brief Lit la valeur entière d'une option, ou arrête le programme avec un message qui nomme l'option.
+ * \param programme Nom du programme.
+ * \param option Nom de l'option.
+ * \param texte Valeur donnée à l'option.
+ * \param min Plus petite valeur acceptée.
+ * \param max Plus grande valeur acceptée.
+ * \return La valeur lue.
+ */
+int lireOption(const char *programme, const char *option, const char *texte, int min, int max);
+
+int main(int argc, char *argv[])
+{
+    int i;
+    long nbFils = sysconf(_SC_NPROCESSORS_ONLN);
+    long parties = NB_PARTIES;
+    uint32_t numero;
+    const char *sortie = "lot.bin";
+    const char *erreur;
+    int64_t duree;
+    long fins[FIN_GAGNEE + 1] = { 0 };
+    double totalTicks = 0, totalPommes = 0;
+    long vols = 0;
+    long decisions = 0;
+    int64_t dureeDecisions = 0, dureeMaxDecision = 0;
+
+    lot.config = configDefaut;
+    lot.graine = 1;
+    lot.ticksMax = TICKS_MAX;
+    for (i = 1; i < argc; i++) { // Lecture des options
+        if (strcmp(argv[i], "--parties") == 0 && i + 1 < argc) {
+            parties = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--fils") == 0 && i + 1 < argc) {
+            nbFils = atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--graine") == 0 && i + 1 < argc) {
+            if (!lireGraine(argv[++i], &lot.graine)) {
+                fprintf(stderr, "%s : --graine attend un entier entre 0 et %llu, pas « %s »\n", argv[0],
+                        (unsigned long long)UINT64_MAX, argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "--sortie") == 0 && i + 1 < argc) {
+            sortie = argv[++i];
+        }
+        else if (strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            lot.ticksMax = (uint32_t)atol(argv[++i]);
+        }
+        else if (strcmp(argv[i], "--paves") == 0 && i + 1 < argc) {
+            lot.config.nbPaves = lireOption(argv[0], "--paves", argv[++i], 0, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--taille-pave") == 0 && i + 1 < argc) {
+            lot.config.taillePave = lireOption(argv[0], "--taille-pave", argv[++i], 0, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--largeur") == 0 && i + 1 < argc) {
+            lot.config.largeur = lireOption(argv[0], "--largeur", argv[++i], MINI_PLATEAU, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--hauteur") == 0 && i + 1 < argc) {
+            lot.config.hauteur = lireOption(argv[0], "--hauteur", argv[++i], MINI_PLATEAU, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--taille") == 0 && i + 1 < argc) {
+            lot.config.tailleSerpent = lireOption(argv[0], "--taille", argv[++i], 1, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--objectif") == 0 && i + 1 < argc) {
+            lot.config.objectif = lireOption(argv[0], "--objectif", argv[++i], 1, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--bits") == 0) {
+            lot.config.stockage = STOCKAGE_BITS;
+        }
+        else if (strcmp(argv[i], "--auto") == 0) {
+            lot.automatique = true;
+        }
+        else {
+            fprintf(stderr, "usage : %s [--parties nombre] [--fils nombre] [--graine graine] [--sortie fichier]\n"
+                            "        %*s [--ticks limite] [--paves nombre] [--taille-pave cote] [--largeur largeur]\n"
+                            "        %*s [--hauteur hauteur] [--taille taille_serpent] [--objectif pommes] [--bits]\n"
+                            "        %*s [--auto]\n",
+                    argv[0], (int)strlen(argv[0]), "", (int)strlen(argv[0]), "", (int)strlen(argv[0]), "");
+            return EXIT_FAILURE;
+        }
+    }
+    erreur = erreurConfig(&lot.config);
+    if (erreur != NULL) {
+        fprintf(stderr, "%s : %s\n", argv[0], erreur);
+        return EXIT_FAILURE;
+    }
+    if (parties < 1 || parties > UINT32_MAX || nbFils < 1 || nbFils > MAX_FILS) {
+        fprintf(stderr, "%s : il faut au moins une partie et entre 1 et %d fils\n", argv[0], MAX_FILS);
+        return EXIT_FAILURE;
+    }
+    if (nbFils > parties) {
+        nbFils = parties;
+    }
+    lot.nbParties = (uint32_t)parties;
+    lot.nbOuvriers = (int)nbFils;
+
+    lot.ticks = malloc(lot.nbParties * sizeof(uint32_t));
+    lot.pommes = malloc(lot.nbParties * sizeof(uint32_t));
+    lot.fins = malloc(lot.nbParties);
+    lot.ouvriers = aligned_alloc(LIGNE_CACHE, lot.nbOuvriers * sizeof(t_ouvrier));
+    if (lot.ticks == NULL || lot.pommes == NULL || lot.fins == NULL || lot.ouvriers == NULL) {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+
+    duree = lancerLot();
+    for (i = 0; i < lot.nbOuvriers; i++) {
+        vols += lot.ouvriers[i].vols;
+        decisions += lot.ouvriers[i].decisions;
+        dureeDecisions += lot.ouvriers[i].dureeDecisions;
+        if (lot.ouvriers[i].dureeMaxDecision > dureeMaxDecision) {
+            dureeMaxDecision = lot.ouvriers[i].dureeMaxDecision;
+        }
+    }
+
+    if (!ecrireResultats(sortie)) {
+        return EXIT_FAILURE;
+    }
+
+    for (numero = 0; numero < lot.nbParties; numero++) { // --parties va jusqu'à UINT32_MAX
+        fins[lot.fins[numero]]++;
+        totalTicks += lot.ticks[numero];
+        totalPommes += lot.pommes[numero];
+    }
+    printf("%u parties sur %d fils en %.3f s : %.1f parties/s, %.0f ticks/s, %ld vols\n",
+           lot.nbParties, lot.nbOuvriers, duree / 1e9, lot.nbParties * 1e9 / duree,
+           totalTicks * 1e9 / duree, vols);
+    printf("Moyennes : %.1f ticks, %.2f pommes par partie\n",
+           totalTicks / lot.nbParties, totalPommes / lot.nbParties);
+    printf("Fins : %ld gagnées, %ld contre un mur, %ld contre le serpent, %ld à la limite de ticks\n",
+           fins[FIN_GAGNEE], fins[FIN_MUR], fins[FIN_SERPENT], fins[FIN_LIMITE]);
+    if (lot.automatique) {
+        printf("Pilote : %ld décisions, %.2f µs en moyenne, %.1f µs au plus par tick\n", decisions,
+               decisions > 0 ? dureeDecisions / 1000.0 / decisions : 0.0, dureeMaxDecision / 1000.0);
+    }
+    printf("Résultats écrits dans %s\n", sortie);
+
+    free(lot.ticks);
+    free(lot.pommes);
+    free(lot.fins);
+    free(lot.ouvriers);
+    return EXIT_SUCCESS;
+}
+
+int64_t maintenant(){
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+bool prendrePartie(t_ouvrier *ouvrier, uint32_t *partie){
+    uint64_t plage = atomic_load(&ouvrier->plage);
+    uint32_t debut, fin;
+
+    do {
+        debut = (uint32_t)(plage >> 32);
+        fin = (uint32_t)plage;
+        if (debut >= fin) {
+            return false;
+        }
+    } while (!atomic_compare_exchange_weak(&ouvrier->plage, &plage, ((uint64_t)(debut + 1) << 32) | fin));
+    *partie = debut;
+    return true;
+}
+
+bool volerParties(t_ouvrier *ouvrier){
+    int k;
+    t_ouvrier *victime;
+    uint64_t plage;
+    uint32_t debut, fin, moitie;
+
+    for (k = 1; k < lot.nbOuvriers; k++) {
+        victime = &lot.ouvriers[(ouvrier->numero + k) % lot.nbOuvriers];
+        plage = atomic_load(&victime->plage);
+        while (true) {
+            debut = (uint32_t)(plage >> 32);
+            fin = (uint32_t)plage;
+            if (debut >= fin || fin - debut < 2) { // La victime finit elle-même sa dernière partie
+                break;
+            }
+            moitie = (fin - debut) / 2;
+            if (atomic_compare_exchange_weak(&victime->plage, &plage, ((uint64_t)debut << 32) | (fin - moitie))) {
+                // Seul ce fil modifie sa plage vide, les voleurs n'y touchent pas
+                atomic_store(&ouvrier->plage, ((uint64_t)(fin - moitie) << 32) | fin);
+                ouvrier->vols++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+char choisirDirection(const t_partie *partie, t_alea *alea){
+    const char directions[4] = { HAUT, BAS, GAUCHE, DROITE };
+    const char opposees[4] = { BAS, HAUT, DROITE, GAUCHE };
+    int decalages[4];
+    int tete = lireSegment(&partie->serpent, 0);
+    int pommeX = abscisse(partie, partie->pomme);
+    int pommeY = ordonnee(partie, partie->pomme);
+    int i, c, distance;
+    int meilleure = -1;
+    int nbMeilleures = 0;
+    char choix = partie->direction;
+
+    decalages[0] = -partie->pas;
+    decalages[1] = partie->pas;
+    decalages[2] = -1;
+    decalages[3] = 1;
+    for (i = 0; i < 4; i++) {
+        c = tete + decalages[i];
+        if (opposees[i] == partie->direction || estMur(partie, c) || estSerpent(&partie->serpent, c)) {
+            continue;
+        }
+        distance = abs(abscisse(partie, c) - pommeX) + abs(ordonnee(partie, c) - pommeY);
+        if (meilleure < 0 || distance < meilleure) { // Nouvelle meilleure direction
+            meilleure = distance;
+            nbMeilleures = 1;
+            choix = directions[i];
+        }
+        else if (distance == meilleure) { // Égalité : chaque direction a la même chance d'être gardée
+            nbMeilleures++;
+            if (aleaBorne(alea, nbMeilleures) == 0) {
+                choix = directions[i];
+            }
+        }
+    }
+    return choix;
+}
+
+char directionJoueur(t_ouvrier *ouvrier, const t_partie *partie, t_alea *alea){
+    if (ouvrier->pilote != NULL) {
+        return choisirChemin(ouvrier->pilote, partie);
+    }
+    return choisirDirection(partie, alea);
+}
+
+void preparerPilote(t_ouvrier *ouvrier, const t_partie *partie){
+    if (!lot.automatique) {
+        return;
+    }
+    ouvrier->pilote = autopiloteCreer(partie);
+    if (ouvrier->pilote == NULL) {
+        perror("autopiloteCreer");
+        exit(EXIT_FAILURE);
+    }
+}
+
+void rendrePilote(t_ouvrier *ouvrier){
+    if (ouvrier->pilote == NULL) {
+        return;
+    }
+    ouvrier->decisions = ouvrier->pilote->decisions;
+    ouvrier->dureeDecisions = ouvrier->pilote->dureeTotale;
+    ouvrier->dureeMaxDecision = ouvrier->pilote->dureeMax;
+    autopiloteDetruire(ouvrier->pilote);
+    ouvrier->pilote = NULL;
+}
+
+void jouerPartie(t_ouvrier *ouvrier, t_partie *partie, uint32_t numero){
+    t_alea joueur;
+    t_resultat resultat;
+    uint32_t tick = 0;
+    uint8_t fin = FIN_LIMITE;
+
+    reinitialiserPartie(partie, lot.graine, numero);
+    initAlea(&joueur, lot.graine, numero + FLUX_JOUEUR);
+    while (tick < lot.ticksMax) {
+        resultat = avancerPartie(partie, directionJoueur(ouvrier, partie, &joueur));
+        tick++;
+        if (partieFinie(&resultat, tick, &fin)) {
+            break;
+        }
+    }
+    rangerResultats(numero, tick, partie->pommeMange, fin);
+}
+
+void rangerResultats(uint32_t numero, uint32_t tick, int pommes, uint8_t fin){
+    lot.ticks[numero] = tick;
+    lot.pommes[numero] = (uint32_t)pommes;
+    lot.fins[numero] = fin;
+}
+
+bool partieFinie(const t_resultat *resultat, uint32_t tick, uint8_t *fin){
+    if (resultat->collision) {
+        *fin = (uint8_t)resultat->mort;
+        return true;
+    }
+    if (resultat->gagne) {
+        *fin = FIN_GAGNEE;
+        return true;
+    }
+    *fin = FIN_LIMITE;
+    return tick >= lot.ticksMax;
+}
+
+void *travailler(void *argument){
+    t_ouvrier *ouvrier = argument;
+    t_partie *partie = partieCreer(&lot.config, lot.graine, 0); // La partie du fil, réutilisée pour chaque numéro
+    uint32_t numero;
+
+    if (partie == NULL) {
+        perror("partieCreer");
+        exit(EXIT_FAILURE);
+    }
+    preparerPilote(ouvrier, partie);
+    while (prendrePartie(ouvrier, &numero) || (volerParties(ouvrier) && prendrePartie(ouvrier, &numero))) {
+        jouerPartie(ouvrier, partie, numero);
+        ouvrier->parties++;
+    }
+    rendrePilote(ouvrier);
+    partieDetruire(partie);
+    return NULL;
+}
+
+int64_t lancerLot(){
+    int i;
+    uint32_t debut = 0, taille;
+    int64_t depart;
+
+    // Chaque fil reçoit une part égale des parties
+    for (i = 0; i < lot.nbOuvriers; i++) {
+        taille = lot.nbParties / lot.nbOuvriers + ((uint32_t)i < lot.nbParties % lot.nbOuvriers);
+        memset(&lot.ouvriers[i], 0, sizeof(t_ouvrier));
+        atomic_init(&lot.ouvriers[i].plage, ((uint64_t)debut << 32) | (debut + taille));
+        lot.ouvriers[i].numero = i;
+        debut += taille;
+    }
+
+    depart = maintenant();
+    for (i = 0; i < lot.nbOuvriers; i++) {
+        if (pthread_create(&lot.ouvriers[i].fil, NULL, travailler, &lot.ouvriers[i]) != 0) {
+            perror("pthread_create");
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (i = 0; i < lot.nbOuvriers; i++) {
+        pthread_join(lot.ouvriers[i].fil, NULL);
+    }
+    return maintenant() - depart;
+}
+
+bool ecrireResultats(const char *chemin){
+    const char noms[NB_COLONNES][TAILLE_NOM] = { "ticks", "pommes", "fin" };
+    const uint32_t tailles[NB_COLONNES] = { sizeof(uint32_t), sizeof(uint32_t), sizeof(uint8_t) };
+    const void *colonnes[NB_COLONNES] = { lot.ticks, lot.pommes, lot.fins };
+    int32_t reglages[] = { lot.config.nbPaves, lot.config.taillePave, lot.config.largeur, lot.config.hauteur,
+                           lot.config.tailleSerpent, lot.config.objectif, lot.config.stockage };
+    uint32_t nbColonnes = NB_COLONNES;
+    FILE *fichier = fopen(chemin, "wb");
+    bool ok;
+    int i;
+
+    if (fichier == NULL) {
+        perror(chemin);
+        return false;
+    }
+    ok = fwrite("SNKL", 1, 4, fichier) == 4
+      && fwrite(&lot.nbParties, sizeof(uint32_t), 1, fichier) == 1
+      && fwrite(&nbColonnes, sizeof(uint32_t), 1, fichier) == 1
+      && fwrite(&lot.graine, sizeof(uint64_t), 1, fichier) == 1
+      && fwrite(reglages, sizeof(reglages), 1, fichier) == 1
+      && fwrite(&lot.ticksMax, sizeof(uint32_t), 1, fichier) == 1;
+    for (i = 0; ok && i < NB_COLONNES; i++) {
+        ok = fwrite(noms[i], TAILLE_NOM, 1, fichier) == 1 && fwrite(&tailles[i], sizeof(uint32_t), 1, fichier) == 1;
+    }
+    for (i = 0; ok && i < NB_COLONNES; i++) {
+        ok = fwrite(colonnes[i], tailles[i], lot.nbParties, fichier) == lot.nbParties;
+    }
+    if (fclose(fichier) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        perror(chemin);
+    }
+    return ok;
+}
+
+int lireOption(const char *programme, const char *option, const char *texte, int min, int max){
+    int valeur;
+
+    if (!lireEntier(texte, min, max, &valeur)) {
+        fprintf(stderr, "%s : %s attend un entier entre %d et %d, pas « %s »\n", programme, option, min, max, texte);
+        exit(EXIT_FAILURE);
+    }
+    return valeur;
+}
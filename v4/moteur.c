@@ -0,0 +1,599 @@
+/**
+* \file moteur.c
+* \brief le moteur du jeu snake
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Règles du jeu : progression du serpent, collisions, pommes et pavés.
+*
+*/
+#include <stdlib.h>
+#include <string.h>
+#include <limits.h>
+#include <errno.h>
+
+#include "moteur.h"
+#include "trace.h"
+
+const t_config configDefaut = { NB_PAVES, TAILLE_PAVE, MAXTAB_X, MAXTAB_Y, TAILLE_SERPENT, MAXPOMME,
+                              STOCKAGE_OCTETS };
+const char lesDirections[NB_DIRECTIONS] = { HAUT, BAS, GAUCHE, DROITE };
+
+// Indice de chaque direction plus un, 0 pour les touches qui ne sont pas des directions
+static const signed char indicesDirections[256] = { [(unsigned char)HAUT] = 1, [(unsigned char)BAS] = 2,
+                                                    [(unsigned char)GAUCHE] = 3, [(unsigned char)DROITE] = 4 };
+
+/**
+ * \brief Arrondit une taille au multiple de LIGNE_CACHE supérieur.
+ * \param taille La taille.
+ * \return La taille arrondie.
+ */
+static size_t arrondirLigne(size_t taille){
+    return (taille + LIGNE_CACHE - 1) / LIGNE_CACHE * LIGNE_CACHE;
+}
+
+/**
+ * \brief Remplit la table des cases suivantes : la case voisine, sauf aux ouvertures de la bordure.
+ *
+ * Une tête qui entre dans une ouverture réapparaît de l'autre côté du plateau.
+ * Les voisines qui sortiraient du tableau des cases (rangée de sentinelles)
+ * sont remplacées par la case elle-même : la tête n'y va jamais.
+ *
+ * \param partie La partie, dont pas, nbCases et decalages sont déjà calculés.
+ */
+static void construireSuivants(t_partie *partie){
+    int largeur = partie->config.largeur;
+    int hauteur = partie->config.hauteur;
+    int c, d, voisine;
+
+    for (c = 0; c < partie->nbCases; c++) {
+        for (d = 0; d < NB_DIRECTIONS; d++) {
+            voisine = c + partie->decalages[d];
+            partie->suivant[c * NB_DIRECTIONS + d] = (voisine >= 0 && voisine < partie->nbCases) ? voisine : c;
+        }
+    }
+    // Les ouvertures au milieu de chaque bordure
+    relierCases(partie, indiceCase(partie, largeur / 2, MINTAB), indiceDirection(HAUT),
+                indiceCase(partie, largeur / 2, hauteur - 2));
+    relierCases(partie, indiceCase(partie, largeur / 2, hauteur - 2), indiceDirection(BAS),
+                indiceCase(partie, largeur / 2, MINTAB));
+    relierCases(partie, indiceCase(partie, MINTAB, hauteur / 2), indiceDirection(GAUCHE),
+                indiceCase(partie, largeur - 2, hauteur / 2));
+    relierCases(partie, indiceCase(partie, largeur - 2, hauteur / 2), indiceDirection(DROITE),
+                indiceCase(partie, MINTAB, hauteur / 2));
+}
+
+int64_t periodeTick(int pommeMange){
+    int64_t periode = PERIODE_DEPART - (int64_t)pommeMange * ACCELERATION;
+
+    if (periode < PERIODE_MIN) {
+        periode = PERIODE_MIN;
+    }
+    return periode;
+}
+
+const char *erreurConfig(const t_config *config){
+    if (config->largeur < MINI_PLATEAU || config->hauteur < MINI_PLATEAU) {
+        return "le plateau doit mesurer au moins 8 cases de côté";
+    }
+    if (arrondirLigne((size_t)config->largeur + 2) * ((size_t)config->hauteur + 2) * NB_DIRECTIONS > INT_MAX) {
+        return "le plateau est trop grand";
+    }
+    if (config->tailleSerpent < 1 || config->tailleSerpent > config->largeur / 2) {
+        return "le serpent doit mesurer entre 1 case et la moitié de la largeur du plateau";
+    }
+    if (config->objectif < 1) {
+        return "l'objectif doit être d'au moins une pomme";
+    }
+    if (config->nbPaves < 0 || config->taillePave < 0) {
+        return "le nombre et la taille des pavés ne peuvent pas être négatifs";
+    }
+    if (config->stockage != STOCKAGE_OCTETS && config->stockage != STOCKAGE_BITS) {
+        return "le stockage du plateau est inconnu";
+    }
+    return NULL;
+}
+
+bool lireEntier(const char *texte, int min, int max, int *valeur){
+    char *fin;
+    long lu;
+
+    errno = 0;
+    lu = strtol(texte, &fin, 10);
+    if (fin == texte || *fin != '\0' || errno == ERANGE || lu < min || lu > max) {
+        return false;
+    }
+    *valeur = (int)lu;
+    return true;
+}
+
+bool lireGraine(const char *texte, uint64_t *graine){
+    char *fin;
+    unsigned long long lu;
+
+    if (*texte < '0' || *texte > '9') { // strtoull accepterait un signe moins et rendrait l'opposé
+        return false;
+    }
+    errno = 0;
+    lu = strtoull(texte, &fin, 10);
+    if (*fin != '\0' || errno == ERANGE || lu > UINT64_MAX) {
+        return false;
+    }
+    *graine = (uint64_t)lu;
+    return true;
+}
+
+t_partie *partieCreer(const t_config *config, uint64_t graine, uint64_t flux){
+    t_partie *partie;
+    size_t pas, nbCases, interieur, tailleCases, tailleOccupation, tailleSerpent, tailleLibres, tailleRangs;
+    size_t tailleSomme;
+    char *zone;
+
+    if (erreurConfig(config) != NULL) {
+        return NULL;
+    }
+    partie = malloc(sizeof(t_partie));
+    if (partie == NULL) {
+        return NULL;
+    }
+
+    // Tailles des tableaux, chacun commençant sur une nouvelle ligne de cache
+    pas = arrondirLigne((size_t)config->largeur + 2); // Une sentinelle de chaque côté
+    nbCases = pas * ((size_t)config->hauteur + 2);
+    interieur = (size_t)(config->largeur - 2) * (config->hauteur - 2);
+    tailleOccupation = arrondirLigne((nbCases + 63) / 64 * sizeof(uint64_t));
+    if (config->stockage == STOCKAGE_BITS) { // Plans des murs et des pommes
+        tailleCases = 2 * tailleOccupation;
+    } else {
+        tailleCases = arrondirLigne(nbCases);
+    }
+    tailleSerpent = arrondirLigne((interieur + 1) * sizeof(int));
+    tailleLibres = arrondirLigne(interieur * sizeof(int));
+    tailleRangs = arrondirLigne(nbCases * sizeof(int));
+    tailleSomme = arrondirLigne(((size_t)config->largeur + 1) * (config->hauteur + 1) * sizeof(int));
+    partie->memoire = tailleCases + tailleOccupation + tailleSerpent + tailleLibres + tailleRangs + tailleSomme
+                    + nbCases * NB_DIRECTIONS * sizeof(int);
+
+    zone = aligned_alloc(LIGNE_CACHE, partie->memoire);
+    if (zone == NULL) {
+        free(partie);
+        return NULL;
+    }
+    partie->zone = zone;
+    partie->config = *config;
+    partie->pas = (int)pas;
+    partie->nbCases = (int)nbCases;
+    if (config->stockage == STOCKAGE_BITS) {
+        partie->cases = NULL;
+        partie->murs = (uint64_t *)zone;
+        partie->pommes = (uint64_t *)(zone + tailleOccupation);
+    } else {
+        partie->cases = zone;
+        partie->murs = NULL;
+        partie->pommes = NULL;
+    }
+    partie->serpent.occupation = (uint64_t *)(zone + tailleCases);
+    partie->serpent.nbMots = (int)((nbCases + 63) / 64);
+    partie->serpent.cases = (int *)(zone + tailleCases + tailleOccupation);
+    partie->serpent.capacite = (int)interieur + 1;
+    partie->libres = (int *)(zone + tailleCases + tailleOccupation + tailleSerpent);
+    partie->rangLibre = (int *)(zone + tailleCases + tailleOccupation + tailleSerpent + tailleLibres);
+    partie->somme = (int *)(zone + tailleCases + tailleOccupation + tailleSerpent + tailleLibres + tailleRangs);
+    partie->suivant = (int *)(zone + tailleCases + tailleOccupation + tailleSerpent + tailleLibres + tailleRangs
+                              + tailleSomme);
+    partie->decalages[indiceDirection(HAUT)] = -partie->pas;
+    partie->decalages[indiceDirection(BAS)] = partie->pas;
+    partie->decalages[indiceDirection(GAUCHE)] = -1;
+    partie->decalages[indiceDirection(DROITE)] = 1;
+    construireSuivants(partie);
+
+    reinitialiserPartie(partie, graine, flux);
+    return partie;
+}
+
+void partieDetruire(t_partie *partie){
+    free(partie->zone);
+    free(partie);
+}
+
+int indiceCase(const t_partie *partie, int x, int y){
+    return (y + 1) * partie->pas + x + 1;
+}
+
+int abscisse(const t_partie *partie, int c){
+    return c % partie->pas - 1;
+}
+
+int ordonnee(const t_partie *partie, int c){
+    return c / partie->pas - 1;
+}
+
+char lireCase(const t_partie *partie, int c){
+    if (partie->cases != NULL) {
+        return partie->cases[c];
+    }
+    if (estMur(partie, c)) {
+        return BORDURE;
+    }
+    return estPomme(partie, c) ? POMME : ESPACE;
+}
+
+void ecrireCase(t_partie *partie, int c, char contenu){
+    uint64_t bit = (uint64_t)1 << (c % 64);
+
+    if (partie->cases != NULL) {
+        partie->cases[c] = contenu;
+        return;
+    }
+    partie->murs[c / 64] &= ~bit;
+    partie->pommes[c / 64] &= ~bit;
+    if (contenu == BORDURE) {
+        partie->murs[c / 64] |= bit;
+    } else if (contenu == POMME) {
+        partie->pommes[c / 64] |= bit;
+    }
+}
+
+int indiceDirection(char direction){
+    return indicesDirections[(unsigned char)direction] - 1;
+}
+
+int caseSuivante(const t_partie *partie, int c, int direction){
+    return partie->suivant[c * NB_DIRECTIONS + direction];
+}
+
+void relierCases(t_partie *partie, int depart, int direction, int arrivee){
+    partie->suivant[depart * NB_DIRECTIONS + direction] = arrivee;
+}
+
+bool estMur(const t_partie *partie, int c){
+    if (partie->cases != NULL) {
+        return partie->cases[c] == BORDURE;
+    }
+    return (partie->murs[c / 64] >> (c % 64)) & 1;
+}
+
+bool estPomme(const t_partie *partie, int c){
+    if (partie->cases != NULL) {
+        return partie->cases[c] == POMME;
+    }
+    return (partie->pommes[c / 64] >> (c % 64)) & 1;
+}
+
+/**
+ * \brief Donne le masque des bits de debut (compris) à fin (non compris) d'un mot.
+ * \param debut Premier bit, de 0 à 63.
+ * \param fin Dernier bit exclu, de 1 à 64.
+ * \return Le masque.
+ */
+static uint64_t masqueBits(int debut, int fin){
+    uint64_t haut = fin == 64 ? ~(uint64_t)0 : ((uint64_t)1 << fin) - 1;
+
+    return haut & ~(((uint64_t)1 << debut) - 1);
+}
+
+/**
+ * \brief Remplit des cases consécutives d'une ligne avec le même contenu.
+ *
+ * En plans de bits, les mots entièrement couverts sont écrits d'un coup.
+ *
+ * \param partie La partie.
+ * \param c Numéro de la première case.
+ * \param n Nombre de cases.
+ * \param contenu BORDURE ou ESPACE.
+ */
+static void remplirCases(t_partie *partie, int c, int n, char contenu){
+    int fin = c + n;
+    int mot, bout;
+    uint64_t masque;
+
+    if (partie->cases != NULL) {
+        memset(partie->cases + c, contenu, n);
+        return;
+    }
+    while (c < fin) {
+        mot = c / 64;
+        bout = (fin - mot * 64 < 64) ? fin - mot * 64 : 64;
+        masque = masqueBits(c % 64, bout);
+        partie->pommes[mot] &= ~masque;
+        if (contenu == BORDURE) {
+            partie->murs[mot] |= masque;
+        } else {
+            partie->murs[mot] &= ~masque;
+        }
+        c = (mot + 1) * 64;
+    }
+}
+
+void initSerpent(t_serpent *serpent, int tete, int taille){
+    int i;
+
+    serpent->tete = -1;
+    serpent->queue = 0;
+    serpent->taille = 0;
+    memset(serpent->occupation, 0, serpent->nbMots * sizeof(uint64_t));
+    for (i = taille - 1; i >= 0; i--) { // La queue est ajoutée en premier, la tête en dernier
+        ajouterTete(serpent, tete - i);
+    }
+}
+
+void ajouterTete(t_serpent *serpent, int c){
+    serpent->occupation[c / 64] |= (uint64_t)1 << (c % 64); // La case devient occupée
+    serpent->tete++;
+    if (serpent->tete == serpent->capacite) { // Retour au début du tampon
+        serpent->tete = 0;
+    }
+    serpent->cases[serpent->tete] = c;
+    serpent->taille++;
+}
+
+int retirerQueue(t_serpent *serpent){
+    int c = serpent->cases[serpent->queue];
+
+    serpent->occupation[c / 64] &= ~((uint64_t)1 << (c % 64)); // La case est libérée
+    serpent->queue++;
+    if (serpent->queue == serpent->capacite) { // Retour au début du tampon
+        serpent->queue = 0;
+    }
+    serpent->taille--;
+    return c;
+}
+
+int lireSegment(const t_serpent *serpent, int i){
+    int indice = serpent->tete - i;
+
+    if (indice < 0) {
+        indice += serpent->capacite;
+    }
+    return serpent->cases[indice];
+}
+
+bool estSerpent(const t_serpent *serpent, int c){
+    return (serpent->occupation[c / 64] >> (c % 64)) & 1;
+}
+
+void reinitialiserPartie(t_partie *partie, uint64_t graine, uint64_t flux){
+    initAlea(&partie->alea, graine, flux);
+    partie->direction = DROITE;
+    partie->pommeMange = 0;
+    // Le serpent part du centre du plateau
+    initSerpent(&partie->serpent, indiceCase(partie, partie->config.largeur / 2, partie->config.hauteur / 2),
+                partie->config.tailleSerpent);
+    initPlateau(partie);
+    ajouterPomme(partie);
+}
+
+void indexerCasesLibres(t_partie *partie){
+    int *libres = partie->libres;       // Copies locales : les écritures dans les tableaux
+    int *rangLibre = partie->rangLibre; // ne peuvent alors pas modifier ces valeurs
+    const uint64_t *occupation = partie->serpent.occupation;
+    const char *cases = partie->cases;
+    int largeur = partie->config.largeur;
+    int hauteur = partie->config.hauteur;
+    int nbLibres = 0;
+    int j, c, debut, fin, mot;
+    uint64_t bits;
+
+    memset(rangLibre, -1, partie->nbCases * sizeof(int));
+    for (j = MINTAB; j < hauteur - 1; j++) { // Seul l'intérieur du plateau peut recevoir une pomme
+        debut = indiceCase(partie, MINTAB, j);
+        fin = indiceCase(partie, largeur - 1, j);
+        if (cases == NULL) { // 64 cases à la fois : ni mur, ni pomme, ni serpent
+            for (mot = debut / 64; mot * 64 < fin; mot++) {
+                bits = ~(partie->murs[mot] | partie->pommes[mot] | occupation[mot])
+                     & masqueBits(mot * 64 < debut ? debut % 64 : 0, fin - mot * 64 < 64 ? fin - mot * 64 : 64);
+                while (bits != 0) { // Une case par bit à 1, dans l'ordre des cases
+                    c = mot * 64 + __builtin_ctzll(bits);
+                    rangLibre[c] = nbLibres;
+                    libres[nbLibres++] = c;
+                    bits &= bits - 1;
+                }
+            }
+            continue;
+        }
+        for (c = debut; c < fin; c++) { // Un octet par case, lu directement
+            if (cases[c] == ESPACE && !((occupation[(unsigned)c / 64] >> ((unsigned)c % 64)) & 1)) {
+                rangLibre[c] = nbLibres;
+                libres[nbLibres++] = c;
+            }
+        }
+    }
+    partie->nbLibres = nbLibres;
+}
+
+void libererCase(t_partie *partie, int c){
+    if (partie->rangLibre[c] >= 0) { // Déjà libre
+        return;
+    }
+    partie->rangLibre[c] = partie->nbLibres;
+    partie->libres[partie->nbLibres] = c;
+    partie->nbLibres++;
+}
+
+void occuperCase(t_partie *partie, int c){
+    int rang = partie->rangLibre[c];
+    int derniere;
+
+    if (rang < 0) { // Déjà occupée
+        return;
+    }
+    partie->nbLibres--;
+    derniere = partie->libres[partie->nbLibres]; // La dernière case libre prend la place de celle retirée
+    partie->libres[rang] = derniere;
+    partie->rangLibre[derniere] = rang;
+    partie->rangLibre[c] = -1;
+}
+
+/**
+ * \brief Place les pavés du plateau sans tirer de position qui chevauche une case bloquée.
+ *
+ * Les tableaux des cases libres servent à ranger les coins possibles,
+ * ils sont reconstruits ensuite par indexerCasesLibres().
+ *
+ * \param partie La partie, dont les bordures et le serpent sont déjà placés.
+ */
+static void placerPaves(t_partie *partie){
+    int *somme = partie->somme;            // cases bloquées au-dessus et à gauche de chaque coin
+    int *positions = partie->libres;       // coins des pavés encore possibles
+    int *rangPosition = partie->rangLibre; // place de chaque coin dans positions, -1 s'il n'y est pas
+    int nbPositions = 0;
+    int k = partie->config.taillePave;
+    int largeur = partie->config.largeur;
+    int hauteur = partie->config.hauteur;
+    int ligne = largeur + 1;
+    int i, j, x, y, c, n, rang, derniere;
+
+    if (k < 1 || k > largeur - 2 || k > hauteur - 2) { // Aucun pavé ne tient dans le plateau
+        return;
+    }
+
+    // Sommes cumulées des cases bloquées : bordures, pavés déjà placés et serpent
+    memset(somme, 0, ligne * sizeof(int));
+    for (j = 0; j < hauteur; j++) {
+        somme[(j + 1) * ligne] = 0;
+        c = indiceCase(partie, 0, j);
+        for (i = 0; i < largeur; i++, c++) {
+            somme[(j + 1) * ligne + i + 1] = somme[j * ligne + i + 1] + somme[(j + 1) * ligne + i]
+                                           - somme[j * ligne + i]
+                                           + (lireCase(partie, c) != ESPACE || estSerpent(&partie->serpent, c));
+        }
+    }
+
+    // Un coin est possible si le carré de côté k qui commence à ce coin ne contient aucune case bloquée
+    memset(rangPosition, -1, partie->nbCases * sizeof(int));
+    for (y = 1; y <= hauteur - 1 - k; y++) {
+        for (x = 1; x <= largeur - 1 - k; x++) {
+            n = somme[(y + k) * ligne + x + k] - somme[y * ligne + x + k]
+              - somme[(y + k) * ligne + x] + somme[y * ligne + x];
+            if (n == 0) {
+                c = indiceCase(partie, x, y);
+                rangPosition[c] = nbPositions;
+                positions[nbPositions++] = c;
+            }
+        }
+    }
+
+    for (n = 0; n < partie->config.nbPaves && nbPositions > 0; n++) {
+        c = positions[aleaBorne(&partie->alea, nbPositions)];
+        for (j = 0; j < k; j++) {
+            for (i = 0; i < k; i++) {
+                ecrireCase(partie, c + j * partie->pas + i, BORDURE);
+            }
+        }
+
+        // Retirer les coins dont le carré chevaucherait le nouveau pavé
+        x = abscisse(partie, c);
+        y = ordonnee(partie, c);
+        for (j = y - k + 1; j < y + k; j++) {
+            for (i = x - k + 1; i < x + k; i++) {
+                if (j < 1 || i < 1 || j > hauteur - 1 - k || i > largeur - 1 - k) {
+                    continue;
+                }
+                c = indiceCase(partie, i, j);
+                rang = rangPosition[c];
+                if (rang < 0) {
+                    continue;
+                }
+                derniere = positions[--nbPositions]; // Le dernier coin prend la place de celui retiré
+                positions[rang] = derniere;
+                rangPosition[derniere] = rang;
+                rangPosition[c] = -1;
+            }
+        }
+    }
+}
+
+void initPlateau(t_partie *partie) {
+    int largeur = partie->config.largeur;
+    int hauteur = partie->config.hauteur;
+    int j;
+
+    // Sentinelles et bordures, puis l'intérieur de chaque ligne
+    remplirCases(partie, 0, partie->nbCases, BORDURE);
+    for (j = MINTAB; j < hauteur - 1; j++) {
+        remplirCases(partie, indiceCase(partie, MINTAB, j), largeur - 2, ESPACE);
+    }
+
+    // Les passages au milieu de chaque bordure
+    ecrireCase(partie, indiceCase(partie, largeur / 2, 0), ESPACE);
+    ecrireCase(partie, indiceCase(partie, largeur / 2, hauteur - 1), ESPACE);
+    ecrireCase(partie, indiceCase(partie, 0, hauteur / 2), ESPACE);
+    ecrireCase(partie, indiceCase(partie, largeur - 1, hauteur / 2), ESPACE);
+
+    placerPaves(partie);
+
+    indexerCasesLibres(partie);
+}
+
+bool ajouterPomme(t_partie *partie){
+    if (partie->nbLibres == 0) { // Le serpent remplit le plateau
+        return false;
+    }
+    partie->pomme = partie->libres[aleaBorne(&partie->alea, partie->nbLibres)];
+    TRACE_INSTANT("pomme placée", partie->nbLibres); // Un seul tirage parmi les cases libres
+    ecrireCase(partie, partie->pomme, POMME);
+    occuperCase(partie, partie->pomme);
+    return true;
+}
+
+void progresser(t_partie *partie, char direction, t_resultat *resultat) {
+    int demandee = indiceDirection(direction);
+    int actuelle = indiceDirection(partie->direction);
+    int tete = lireSegment(&partie->serpent, 0);
+
+    // Changer de direction uniquement si elle est connue et n'est pas opposée
+    if (demandee >= 0 && demandee != (actuelle ^ 1)) {
+        actuelle = demandee;
+    }
+    partie->direction = lesDirections[actuelle];
+
+    // La voisine décide du mur, la table donne la case d'arrivée, passage par la bordure compris
+    terminerProgression(partie, caseSuivante(partie, tete, actuelle), estMur(partie, tete + partie->decalages[actuelle]),
+                        resultat);
+}
+
+void terminerProgression(t_partie *partie, int nouvelleTete, bool mur, t_resultat *resultat) {
+    resultat->collision = mur;
+    resultat->mort = mur ? MORT_MUR : MORT_AUCUNE;
+    resultat->pomme = false;
+    resultat->gagne = false;
+
+    // Vérifier les collisions avec le corps du serpent
+    if (estSerpent(&partie->serpent, nouvelleTete) && !resultat->collision) {
+        resultat->collision = true;
+        resultat->mort = MORT_SERPENT;
+    }
+    if (resultat->collision) {
+        TRACE_INSTANT("collision", resultat->mort);
+    }
+
+    // Vérifier si la tête rencontre une pomme, elle disparaît alors du plateau
+    if (estPomme(partie, nouvelleTete)) {
+        resultat->pomme = true;
+        ecrireCase(partie, nouvelleTete, ESPACE);
+        partie->pommeMange++;
+        resultat->gagne = partie->pommeMange >= partie->config.objectif;
+        TRACE_INSTANT("pomme mangée", partie->pommeMange);
+    }
+
+    // La queue n'est pas retirée quand le serpent grandit
+    if (resultat->pomme == false) {
+        resultat->queue = retirerQueue(&partie->serpent);
+        libererCase(partie, resultat->queue);
+    }
+
+    // Mettre à jour la tête
+    ajouterTete(&partie->serpent, nouvelleTete);
+    occuperCase(partie, nouvelleTete);
+}
+
+t_resultat avancerPartie(t_partie *partie, char direction){
+    t_resultat resultat;
+
+    progresser(partie, direction, &resultat);
+    if (resultat.pomme && !resultat.gagne && !ajouterPomme(partie)) {
+        resultat.gagne = true; // Plus aucune case libre pour une pomme
+    }
+    return resultat;
+}
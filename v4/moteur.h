@@ -0,0 +1,433 @@
+/**
+* \file moteur.h
+* \brief le moteur du jeu snake
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Le moteur contient tout l'état d'une partie : le plateau, le serpent
+* et le générateur pseudo-aléatoire (alea.c). Ses fonctions n'écrivent rien
+* dans le terminal et n'attendent jamais, plusieurs parties peuvent donc
+* avancer en même temps sans terminal, par exemple pour les mesures de performance.
+*
+* Les dimensions du plateau sont choisies à la création de la partie.
+* Une case est désignée par son numéro dans le plateau (voir indiceCase()),
+* le serpent et l'ensemble des cases libres ne stockent que ces numéros.
+*
+*/
+#ifndef MOTEUR_H
+#define MOTEUR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "alea.h"
+
+#define MAXTAB_X 80 //constante pour la largeur par défaut du plateau
+#define MAXTAB_Y 40 //constante pour la hauteur par défaut du plateau
+#define MINTAB 1 //constante pour la Taille Min d’un tableau
+#define MINI_PLATEAU 8 //constante pour la largeur et la hauteur minimales du plateau
+#define TAILLE_SERPENT 10 //constante pour la Taille du serpent au départ, par défaut
+#define HAUT 'z' //constante pour la touche de direction "haut"
+#define BAS 's' //constante pour la touche de direction "bas"
+#define GAUCHE 'q' //constante pour la touche de direction "gauche"
+#define DROITE 'd' //constante pour la touche de direction "droite"
+#define ARRET 'a' //constante pour la touche d'arret du programme
+#define PAUSE 'p' //constante pour la touche de pause
+#define BORDURE '#' //constante pour les bordures du plateau de jeu
+#define ESPACE ' ' //constante pour le l'intérieure des bordures du plateau
+#define POMME '6' //constante pour le caractère des pommes
+#define MAXPOMME 10 //constante pour le nombre de pommes à mangé pour gagner, par défaut
+#define NB_PAVES 5 //constante pour le nombre de pavés par défaut
+#define TAILLE_PAVE 5 //constante pour le côté des pavés par défaut
+#define LIGNE_CACHE 64 //constante pour l'alignement des tableaux de la partie
+#define STOCKAGE_OCTETS 0 //constante pour un plateau stocké avec un octet par case
+#define STOCKAGE_BITS 1 //constante pour un plateau stocké en plans de bits
+#define MORT_AUCUNE 0 //constante pour un tick sans collision
+#define MORT_MUR 1 //constante pour une collision avec une bordure ou un pavé
+#define MORT_SERPENT 2 //constante pour une collision avec le serpent
+#define NB_DIRECTIONS 4 //constante pour le nombre de directions du serpent
+#define PERIODE_DEPART 200000000 //constante pour la durée d'un tick au départ, en nanosecondes
+#define ACCELERATION 15000000 //constante pour le raccourcissement d'un tick par pomme mangée
+#define PERIODE_MIN 20000000 //constante pour la durée minimale d'un tick
+
+/**
+ * \brief Réglages d'une partie, choisis avant sa création.
+ */
+typedef struct {
+    int nbPaves;       // nombre de pavés carrés placés sur le plateau
+    int taillePave;    // côté des pavés
+    int largeur;       // largeur du plateau, bordures comprises
+    int hauteur;       // hauteur du plateau, bordures comprises
+    int tailleSerpent; // nombre de segments du serpent au départ
+    int objectif;      // nombre de pommes à manger pour gagner
+    int stockage;      // STOCKAGE_OCTETS ou STOCKAGE_BITS, sans effet sur le déroulement de la partie
+} t_config;
+
+extern const t_config configDefaut; // réglages de la partie d'origine
+extern const char lesDirections[NB_DIRECTIONS]; // HAUT, BAS, GAUCHE, DROITE : l'opposée de l'indice d est d ^ 1
+
+/**
+ * \brief Serpent stocké dans un tampon circulaire.
+ *
+ * Les segments vont de la queue vers la tête en avançant dans le tampon,
+ * une progression ajoute une tête et retire la queue sans décaler le corps.
+ * La carte d'occupation garde un bit par case du plateau, mis à jour quand
+ * la tête entre dans une case et quand la queue la quitte.
+ */
+typedef struct {
+    int *cases;            // numéros des cases des segments
+    int capacite;          // nombre de segments que peut contenir le tampon
+    int tete;              // indice de la tête dans le tampon
+    int queue;             // indice de la queue dans le tampon
+    int taille;            // nombre de segments actuellement actifs
+    uint64_t *occupation;  // un bit par case occupée par le serpent
+    int nbMots;            // nombre de mots de la carte d'occupation
+} t_serpent;
+
+/**
+ * \brief État complet d'une partie.
+ *
+ * Tous les tableaux sont pris dans une seule zone mémoire alignée sur
+ * LIGNE_CACHE octets. Les lignes du plateau sont espacées de pas cases,
+ * un multiple de LIGNE_CACHE, et le plateau est entouré d'une rangée de
+ * cases sentinelles (BORDURE) : les quatre voisines de n'importe quelle
+ * case du plateau existent, sans test de limites.
+ *
+ * Le contenu des cases est stocké selon config.stockage :
+ *   - STOCKAGE_OCTETS : un octet par case dans cases ;
+ *   - STOCKAGE_BITS : un bit par case dans le plan des murs (bordures et pavés)
+ *     et dans celui des pommes, cases valant alors NULL. Le plan du serpent est
+ *     sa carte d'occupation. Le plateau occupe quatre fois moins de mémoire et
+ *     les cases libres se cherchent par mots de 64 cases.
+ * Le reste du moteur passe par lireCase(), ecrireCase() et les tests de cases,
+ * les deux stockages donnent exactement la même partie.
+ *
+ * Les cases libres de l'intérieur du plateau (ni pavé, ni pomme, ni serpent)
+ * sont rangées au début du tableau libres, dans n'importe quel ordre.
+ * rangLibre donne pour chaque case sa place dans libres, ou -1 si elle
+ * n'est pas libre : une case entre ou sort de l'ensemble en temps constant
+ * en échangeant sa place avec la dernière case libre.
+ *
+ * La table suivant donne, pour chaque case c et chaque direction d (indice
+ * dans lesDirections), la case atteinte par la tête : suivant[c * NB_DIRECTIONS + d].
+ * Le passage par les ouvertures de la bordure y est déjà résolu, une
+ * progression ne fait qu'une lecture dans la table. Elle ne dépend que de
+ * la taille du plateau et des passages : elle est construite à la création
+ * de la partie et n'est pas refaite à chaque réinitialisation.
+ */
+typedef struct {
+    t_config config;       // réglages de la partie
+    int pas;               // distance entre deux lignes du plateau, en cases
+    int nbCases;           // nombre de cases du plateau, sentinelles comprises
+    char *cases;           // contenu des cases : bordures, pavés et pomme (STOCKAGE_OCTETS)
+    uint64_t *murs;        // un bit par case de bordure ou de pavé (STOCKAGE_BITS)
+    uint64_t *pommes;      // un bit par case de pomme (STOCKAGE_BITS)
+    t_serpent serpent;     // le serpent
+    int *libres;           // numéros des cases libres
+    int *rangLibre;        // place de chaque case dans libres, -1 si elle n'est pas libre
+    int nbLibres;          // nombre de cases libres
+    int *somme;            // sommes cumulées des cases bloquées, pour placer les pavés
+    int *suivant;          // case atteinte depuis chaque case dans chaque direction, passages compris
+    int decalages[NB_DIRECTIONS]; // écart entre une case et sa voisine dans chaque direction
+    void *zone;            // zone mémoire qui contient tous les tableaux
+    size_t memoire;        // taille de la zone mémoire en octets
+    t_alea alea;           // générateur pseudo-aléatoire de la partie
+    char direction;        // direction actuelle du serpent
+    int pommeMange;        // nombre de pommes mangées
+    int pomme;             // case de la pomme
+} t_partie;
+
+/**
+ * \brief Résultat d'une progression du serpent.
+ */
+typedef struct {
+    bool collision; // la tête a heurté une bordure, un pavé ou le serpent
+    int mort;       // cause de la collision : MORT_AUCUNE, MORT_MUR ou MORT_SERPENT
+    bool pomme;     // le serpent a mangé une pomme
+    bool gagne;     // le nombre de pommes pour gagner est atteint
+    int queue;      // case libérée par la queue, si pas de pomme
+} t_resultat;
+
+/**
+ * \brief Calcule la durée d'un tick selon le nombre de pommes mangées.
+ *
+ * Le tick raccourcit à chaque pomme sans descendre sous PERIODE_MIN.
+ * Le moteur n'attend jamais : c'est au programme qui fait avancer la
+ * partie de respecter cette durée.
+ *
+ * \param pommeMange Nombre de pommes mangées.
+ * \return La durée d'un tick en nanosecondes.
+ */
+int64_t periodeTick(int pommeMange);
+
+/**
+ * \brief Vérifie des réglages.
+ * \param config Les réglages.
+ * \return NULL si les réglages sont valides, sinon un message qui explique le problème.
+ */
+const char *erreurConfig(const t_config *config);
+
+/**
+ * \brief Lit un entier écrit en décimal, comme la valeur d'une option.
+ * \param texte Le texte, sans rien après l'entier.
+ * \param min Plus petite valeur acceptée.
+ * \param max Plus grande valeur acceptée.
+ * \param valeur Reçoit l'entier lu, inchangée en cas d'échec.
+ * \return false si le texte n'est pas un entier ou si l'entier sort des bornes.
+ */
+bool lireEntier(const char *texte, int min, int max, int *valeur);
+
+/**
+ * \brief Lit une graine écrite en décimal, comme la valeur d'une option.
+ * \param texte Le texte, sans signe ni rien après le nombre.
+ * \param graine Reçoit la graine lue, inchangée en cas d'échec.
+ * \return false si le texte n'est pas un nombre ou dépasse 64 bits.
+ */
+bool lireGraine(const char *texte, uint64_t *graine);
+
+/**
+ * \brief Crée une partie : alloue sa zone mémoire et démarre une première partie.
+ * \param config Réglages de la partie, à vérifier avec erreurConfig().
+ * \param graine Graine du générateur pseudo-aléatoire de la partie.
+ * \param flux Numéro du flux du générateur.
+ * \return La partie, ou NULL si les réglages sont invalides ou si la mémoire manque.
+ */
+t_partie *partieCreer(const t_config *config, uint64_t graine, uint64_t flux);
+
+/**
+ * \brief Libère une partie créée par partieCreer().
+ * \param partie La partie.
+ */
+void partieDetruire(t_partie *partie);
+
+/**
+ * \brief Donne le numéro d'une case.
+ *
+ * Les voisines de la case c sont c - 1, c + 1, c - pas et c + pas.
+ *
+ * \param partie La partie.
+ * \param x Position en abscisse, de -1 à largeur.
+ * \param y Position en ordonnée, de -1 à hauteur.
+ * \return Le numéro de la case.
+ */
+int indiceCase(const t_partie *partie, int x, int y);
+
+/**
+ * \brief Donne la position en abscisse d'une case.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ * \return La position en abscisse.
+ */
+int abscisse(const t_partie *partie, int c);
+
+/**
+ * \brief Donne la position en ordonnée d'une case.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ * \return La position en ordonnée.
+ */
+int ordonnee(const t_partie *partie, int c);
+
+/**
+ * \brief Lit le contenu d'une case du plateau : BORDURE, ESPACE ou POMME.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ * \return Le contenu de la case.
+ */
+char lireCase(const t_partie *partie, int c);
+
+/**
+ * \brief Change le contenu d'une case du plateau.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ * \param contenu BORDURE, ESPACE ou POMME.
+ */
+void ecrireCase(t_partie *partie, int c, char contenu);
+
+/**
+ * \brief Indique si une case est une bordure ou un pavé.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ * \return true si la case bloque le serpent.
+ */
+bool estMur(const t_partie *partie, int c);
+
+/**
+ * \brief Indique si une case contient une pomme.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ * \return true si la case contient une pomme.
+ */
+bool estPomme(const t_partie *partie, int c);
+
+/**
+ * \brief Donne l'indice d'une direction dans lesDirections.
+ * \param direction HAUT, BAS, GAUCHE ou DROITE.
+ * \return L'indice, ou -1 si la direction est inconnue.
+ */
+int indiceDirection(char direction);
+
+/**
+ * \brief Donne la case atteinte par la tête depuis une case dans une direction.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ * \param direction Indice de la direction dans lesDirections.
+ * \return La case d'arrivée, après le passage éventuel par la bordure.
+ */
+int caseSuivante(const t_partie *partie, int c, int direction);
+
+/**
+ * \brief Crée un passage : depuis une case, une direction mène à une case quelconque du plateau.
+ *
+ * Le passage reste en place après reinitialiserPartie(). La case voisine
+ * dans cette direction doit rester libre : c'est elle qui décide de la
+ * collision avec un mur, comme pour les ouvertures de la bordure.
+ *
+ * \param partie La partie.
+ * \param depart Case de départ de la tête.
+ * \param direction Indice de la direction dans lesDirections.
+ * \param arrivee Case où arrive la tête.
+ */
+void relierCases(t_partie *partie, int depart, int direction, int arrivee);
+
+/**
+ * \brief Place le serpent à l'horizontale, la tête à droite.
+ * \param serpent Le serpent à initialiser.
+ * \param tete Case de la tête.
+ * \param taille Nombre de segments du serpent.
+ */
+void initSerpent(t_serpent *serpent, int tete, int taille);
+
+/**
+ * \brief Ajoute une nouvelle tête au serpent.
+ * \param serpent Le serpent.
+ * \param c Case de la nouvelle tête.
+ */
+void ajouterTete(t_serpent *serpent, int c);
+
+/**
+ * \brief Retire le dernier segment du serpent.
+ * \param serpent Le serpent.
+ * \return La case libérée.
+ */
+int retirerQueue(t_serpent *serpent);
+
+/**
+ * \brief Lit la case d'un segment du serpent.
+ * \param serpent Le serpent.
+ * \param i Rang du segment en partant de la tête (0 pour la tête).
+ * \return La case du segment.
+ */
+int lireSegment(const t_serpent *serpent, int i);
+
+/**
+ * \brief Indique si une case est occupée par le serpent.
+ * \param serpent Le serpent.
+ * \param c Numéro de la case.
+ * \return true si un segment du serpent occupe la case.
+ */
+bool estSerpent(const t_serpent *serpent, int c);
+
+/**
+ * \brief Démarre une nouvelle partie : serpent au départ, plateau, pavés et première pomme.
+ *
+ * Le serpent part du centre du plateau vers la droite.
+ * Deux parties de mêmes réglages démarrées avec la même graine et le même flux
+ * sont identiques. Des parties jouées en parallèle utilisent des flux différents.
+ *
+ * \param partie La partie.
+ * \param graine Graine du générateur pseudo-aléatoire de la partie.
+ * \param flux Numéro du flux du générateur.
+ */
+void reinitialiserPartie(t_partie *partie, uint64_t graine, uint64_t flux);
+
+/**
+ * \brief Initialise les bordures et les pavés du plateau de jeu.
+ *
+ * Une table des sommes cumulées des cases bloquées donne en temps constant
+ * le nombre de cases bloquées sous chaque pavé possible. Toutes les positions
+ * libres sont rangées dans un ensemble où chaque pavé est tiré directement,
+ * puis les positions qu'il chevauche en sont retirées. S'il ne reste plus de
+ * position libre, les pavés restants ne sont pas placés.
+ *
+ * \param partie La partie, dont le serpent est déjà placé.
+ */
+void initPlateau(t_partie *partie);
+
+/**
+ * \brief Reconstruit l'ensemble des cases libres à partir du plateau et du serpent.
+ *
+ * À appeler après avoir modifié le plateau ou le serpent sans passer par le moteur.
+ *
+ * \param partie La partie.
+ */
+void indexerCasesLibres(t_partie *partie);
+
+/**
+ * \brief Ajoute une case à l'ensemble des cases libres si elle n'y est pas.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ */
+void libererCase(t_partie *partie, int c);
+
+/**
+ * \brief Retire une case de l'ensemble des cases libres si elle y est.
+ * \param partie La partie.
+ * \param c Numéro de la case.
+ */
+void occuperCase(t_partie *partie, int c);
+
+/**
+ * \brief Place une pomme sur une case libre du plateau, tirée uniformément.
+ *
+ * Le tirage se fait directement dans l'ensemble des cases libres, sa durée
+ * ne dépend pas du remplissage du plateau.
+ *
+ * \param partie La partie.
+ * \return false si aucune case n'est libre.
+ */
+bool ajouterPomme(t_partie *partie);
+
+/**
+ * \brief Met à jour la position du serpent dans la direction demandée.
+ *
+ * Une direction opposée à la direction actuelle ou inconnue est ignorée.
+ * La tête est ajoutée et la queue retirée, sauf si une pomme est mangée :
+ * le serpent grandit alors d'un segment. Aucune nouvelle pomme n'est placée.
+ *
+ * \param partie La partie.
+ * \param direction Direction demandée.
+ * \param resultat Ce qui s'est passé pendant la progression.
+ */
+void progresser(t_partie *partie, char direction, t_resultat *resultat);
+
+/**
+ * \brief Termine une progression dont la case d'arrivée de la tête est déjà calculée.
+ *
+ * Vérifie la collision avec le serpent, mange la pomme éventuelle puis
+ * déplace le serpent. progresser() calcule la case d'arrivée puis appelle
+ * cette fonction, les moteurs qui avancent plusieurs parties à la fois
+ * l'appellent directement pour obtenir exactement le même résultat.
+ *
+ * \param partie La partie, dont la direction est déjà mise à jour.
+ * \param nouvelleTete Case d'arrivée de la tête, après le passage éventuel par la bordure.
+ * \param mur La tête a heurté une bordure ou un pavé.
+ * \param resultat Ce qui s'est passé pendant la progression.
+ */
+void terminerProgression(t_partie *partie, int nouvelleTete, bool mur, t_resultat *resultat);
+
+/**
+ * \brief Avance la partie d'un tick : progression puis nouvelle pomme si besoin.
+ *
+ * Si le serpent remplit tout le plateau, aucune pomme ne peut être placée
+ * et la partie est gagnée.
+ *
+ * \param partie La partie.
+ * \param direction Direction demandée.
+ * \return Ce qui s'est passé pendant le tick.
+ */
+t_resultat avancerPartie(t_partie *partie, char direction);
+
+#endif
@@ -0,0 +1,306 @@
+/**
+* \file spectateur.c
+* \brief le spectateur d'une partie diffusée
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Le spectateur se connecte à la socket d'une partie lancée avec
+* version4 --diffuser et l'affiche dans le terminal : l'image reçue est
+* dessinée entièrement, puis chaque delta ne redessine que la tête,
+* l'ancienne tête, la case libérée par la queue et la nouvelle pomme.
+* Une nouvelle image, envoyée quand le spectateur a pris trop de retard,
+* redessine tout le plateau.
+*
+* Seul le coin en haut à gauche du plateau qui tient dans le terminal est affiché.
+*
+* Compilation : gcc -o spectateur spectateur.c diffusion.c moteur.c alea.c
+* Utilisation : ./spectateur socket
+*
+*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <errno.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/ioctl.h>
+
+#include "diffusion.h"
+#include "affichage.h"
+
+#define TAILLE_RECEPTION 65536 //constante pour la taille de départ du tampon de réception
+
+/**
+ * \brief Plateau tel que le spectateur le connaît.
+ */
+typedef struct {
+    char *cases;     // caractère de chaque case, ligne par ligne
+    int largeur;     // largeur du plateau
+    int hauteur;     // hauteur du plateau
+    int colonnes;    // colonnes du plateau affichées
+    int lignes;      // lignes du plateau affichées
+    int teteX;       // abscisse de la tête
+    int teteY;       // ordonnée de la tête
+    int pommes;      // nombre de pommes mangées
+    int objectif;    // nombre de pommes pour gagner
+    long images;     // images reçues
+    long deltas;     // deltas reçus
+    bool fini;       // la partie s'est terminée
+    bool gagne;      // la partie a été gagnée
+} t_plateau;
+
+/**
+ * \brief Trame en construction, envoyée au terminal par un seul write().
+ */
+typedef struct {
+    char *octets;    // octets de la trame
+    size_t longueur; // nombre d'octets de la trame
+    size_t capacite; // taille du tampon
+} t_trame;
+
+t_plateau plateau;
+t_trame trame;
+
+/**
+ * \brief Ajoute des octets à la trame, en agrandissant son tampon si besoin.
+ * \param octets Les octets.
+ * \param n Nombre d'octets.
+ */
+void ajouterTrame(const char *octets, size_t n);
+
+/**
+ * \brief Envoie la trame au terminal et la vide.
+ */
+void envoyerTrame();
+
+/**
+ * \brief Change une case du plateau et la dessine si elle est affichée.
+ * \param x Abscisse de la case.
+ * \param y Ordonnée de la case.
+ * \param contenu Nouveau caractère de la case.
+ */
+void changerCase(int x, int y, char contenu);
+
+/**
+ * \brief Dessine la ligne d'état sous le plateau.
+ */
+void dessinerEtat();
+
+/**
+ * \brief Remplace le plateau par une image reçue et le redessine entièrement.
+ * \param message L'image.
+ * \return false si la mémoire manque.
+ */
+bool appliquerImage(const t_message *message);
+
+/**
+ * \brief Applique un delta reçu au plateau.
+ * \param message Le delta.
+ */
+void appliquerDelta(const t_message *message);
+
+int main(int argc, char *argv[])
+{
+    struct sockaddr_un adresse = { .sun_family = AF_UNIX };
+    uint8_t *reception, *agrandie;
+    size_t capacite = TAILLE_RECEPTION;
+    size_t recus = 0, position;
+    ssize_t n;
+    long taille;
+    t_message message;
+    int fd;
+
+    if (argc != 2 || strlen(argv[1]) >= sizeof(adresse.sun_path)) {
+        fprintf(stderr, "usage : %s socket\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    strcpy(adresse.sun_path, argv[1]);
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1 || connect(fd, (struct sockaddr *)&adresse, sizeof(adresse)) == -1) {
+        perror(argv[1]);
+        return EXIT_FAILURE;
+    }
+    reception = malloc(capacite);
+    if (reception == NULL) {
+        perror("malloc");
+        return EXIT_FAILURE;
+    }
+
+    system("clear");
+    while ((n = read(fd, reception + recus, capacite - recus)) != 0) {
+        if (n < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            perror("read");
+            return EXIT_FAILURE;
+        }
+        recus += (size_t)n;
+
+        // Appliquer tous les messages complets, puis garder le début du suivant
+        position = 0;
+        while ((taille = lireMessage(reception + position, recus - position, &message)) > 0) {
+            if (message.type == MESSAGE_IMAGE) {
+                if (!appliquerImage(&message)) {
+                    perror("malloc");
+                    return EXIT_FAILURE;
+                }
+            }
+            else {
+                appliquerDelta(&message);
+            }
+            position += (size_t)taille;
+        }
+        if (taille < 0) {
+            fprintf(stderr, "%s : message invalide\n", argv[0]);
+            return EXIT_FAILURE;
+        }
+        dessinerEtat();
+        envoyerTrame();
+        memmove(reception, reception + position, recus - position);
+        recus -= position;
+
+        if (recus == capacite) { // Un message plus grand que le tampon : une image d'un grand plateau
+            capacite *= 2;
+            agrandie = realloc(reception, capacite);
+            if (agrandie == NULL) {
+                perror("realloc");
+                return EXIT_FAILURE;
+            }
+            reception = agrandie;
+        }
+    }
+    close(fd);
+
+    printf("\033[%d;1H\n", plateau.lignes + 2);
+    if (plateau.fini) {
+        printf(plateau.gagne ? "YOU WIN !\n" : "GAME OVER !\n");
+    }
+    printf("Fin de la diffusion : %ld images et %ld deltas reçus\n", plateau.images, plateau.deltas);
+    free(reception);
+    free(plateau.cases);
+    free(trame.octets);
+    return EXIT_SUCCESS;
+}
+
+void ajouterTrame(const char *octets, size_t n){
+    char *agrandie;
+
+    if (trame.longueur + n > trame.capacite) {
+        trame.capacite = (trame.longueur + n) * 2;
+        agrandie = realloc(trame.octets, trame.capacite);
+        if (agrandie == NULL) {
+            perror("realloc");
+            exit(EXIT_FAILURE);
+        }
+        trame.octets = agrandie;
+    }
+    memcpy(trame.octets + trame.longueur, octets, n);
+    trame.longueur += n;
+}
+
+void envoyerTrame(){
+    size_t envoye = 0;
+    ssize_t n;
+
+    while (envoye < trame.longueur) {
+        n = write(STDOUT_FILENO, trame.octets + envoye, trame.longueur - envoye);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        envoye += (size_t)n;
+    }
+    trame.longueur = 0;
+}
+
+void changerCase(int x, int y, char contenu){
+    char texte[32];
+    int n;
+
+    if (x < 0 || x >= plateau.largeur || y < 0 || y >= plateau.hauteur) {
+        return;
+    }
+    plateau.cases[y * plateau.largeur + x] = contenu;
+    if (x < plateau.colonnes && y < plateau.lignes) {
+        n = snprintf(texte, sizeof(texte), "\033[%d;%dH%c", y + 1, x + 1, contenu);
+        ajouterTrame(texte, (size_t)n);
+    }
+}
+
+void dessinerEtat(){
+    char texte[128];
+    int n;
+
+    n = snprintf(texte, sizeof(texte), "\033[%d;1H\033[KPommes : %d / %d   Images : %ld   Deltas : %ld",
+                 plateau.lignes + 1, plateau.pommes, plateau.objectif, plateau.images, plateau.deltas);
+    ajouterTrame(texte, (size_t)n);
+}
+
+bool appliquerImage(const t_message *message){
+    struct winsize taille;
+    char *cases;
+    int y;
+
+    if (message->largeur != plateau.largeur || message->hauteur != plateau.hauteur) {
+        cases = realloc(plateau.cases, (size_t)message->largeur * message->hauteur);
+        if (cases == NULL) {
+            return false;
+        }
+        plateau.cases = cases;
+        plateau.largeur = message->largeur;
+        plateau.hauteur = message->hauteur;
+    }
+    memcpy(plateau.cases, message->cases, (size_t)plateau.largeur * plateau.hauteur);
+    plateau.teteX = message->teteX;
+    plateau.teteY = message->teteY;
+    plateau.pommes = message->pommes;
+    plateau.objectif = message->objectif;
+    plateau.images++;
+
+    // Garder une ligne sous le plateau pour l'état
+    plateau.colonnes = plateau.largeur;
+    plateau.lignes = plateau.hauteur;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &taille) == 0 && taille.ws_col > 0 && taille.ws_row > 1) {
+        plateau.colonnes = taille.ws_col < plateau.colonnes ? taille.ws_col : plateau.colonnes;
+        plateau.lignes = taille.ws_row - 1 < plateau.lignes ? taille.ws_row - 1 : plateau.lignes;
+    }
+
+    ajouterTrame("\033[2J", 4);
+    for (y = 0; y < plateau.lignes; y++) {
+        changerCase(0, y, plateau.cases[y * plateau.largeur]); // Place le curseur au début de la ligne
+        ajouterTrame(plateau.cases + y * plateau.largeur + 1, (size_t)plateau.colonnes - 1);
+    }
+    return true;
+}
+
+void appliquerDelta(const t_message *message){
+    if (plateau.cases == NULL) {
+        return; // Pas encore d'image
+    }
+    // La queue libère sa case avant que la tête n'y entre
+    if (message->drapeaux & DELTA_QUEUE) {
+        changerCase(message->queueX, message->queueY, ESPACE);
+    }
+    changerCase(plateau.teteX, plateau.teteY, ANNEAUX);
+    changerCase(message->teteX, message->teteY, TETE);
+    plateau.teteX = message->teteX;
+    plateau.teteY = message->teteY;
+    if (message->drapeaux & DELTA_MANGEE) {
+        plateau.pommes++;
+    }
+    if (message->drapeaux & DELTA_NOUVELLE) {
+        changerCase(message->pommeX, message->pommeY, POMME);
+    }
+    if (message->drapeaux & (DELTA_COLLISION | DELTA_GAGNE)) {
+        plateau.fini = true;
+        plateau.gagne = (message->drapeaux & DELTA_GAGNE) != 0;
+    }
+    plateau.deltas++;
+}
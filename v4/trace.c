@@ -0,0 +1,105 @@
+/**
+* \file trace.c
+* \brief le traçage des évènements du jeu snake
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+*/
+#include "trace.h"
+
+#ifdef TRACE
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+
+_Thread_local t_anneau *anneauTrace = NULL;
+
+static _Atomic(t_anneau *) anneaux = NULL; // anneaux de tous les fils, le dernier créé en tête
+static atomic_int nbFils = 0;
+static pthread_once_t origineFixee = PTHREAD_ONCE_INIT;
+static uint64_t origineDate;  // date du premier anneau créé
+static int64_t origineHorloge; // horloge monotone au même moment, en nanosecondes
+
+/**
+ * \brief Donne la date actuelle de l'horloge monotone.
+ * \return La date en nanosecondes.
+ */
+static int64_t horloge(){
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
+
+/**
+ * \brief Note la date et l'horloge du début de la trace, qui servent à convertir les dates.
+ */
+static void fixerOrigine(){
+    origineHorloge = horloge();
+    origineDate = dateTrace();
+}
+
+t_anneau *creerAnneau(){
+    t_anneau *anneau = calloc(1, sizeof(t_anneau));
+
+    if (anneau == NULL) {
+        return NULL;
+    }
+    pthread_once(&origineFixee, fixerOrigine);
+    anneau->fil = atomic_fetch_add(&nbFils, 1) + 1;
+    anneau->suivant = atomic_load(&anneaux);
+    while (!atomic_compare_exchange_weak(&anneaux, &anneau->suivant, anneau)) {
+        // Un autre fil vient d'ajouter son anneau : anneau->suivant a été mis à jour
+    }
+    anneauTrace = anneau;
+    return anneau;
+}
+
+bool ecrireTrace(const char *chemin){
+    FILE *fichier;
+    t_anneau *anneau;
+    const t_evenement *evenement;
+    uint64_t i, premier, dateFin;
+    double nanosecondes; // durée d'une unité de date
+    bool virgule = false;
+
+    fichier = fopen(chemin, "w");
+    if (fichier == NULL) {
+        return false;
+    }
+    // Les cycles sont convertis d'après l'horloge monotone entre le premier anneau et maintenant
+    dateFin = dateTrace();
+    nanosecondes = dateFin > origineDate ? (double)(horloge() - origineHorloge) / (dateFin - origineDate) : 1.0;
+
+    fprintf(fichier, "{\"traceEvents\":[\n");
+    for (anneau = atomic_load(&anneaux); anneau != NULL; anneau = anneau->suivant) {
+        fprintf(fichier, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"fil %d\"}}",
+                virgule ? ",\n" : "", anneau->fil, anneau->fil);
+        virgule = true;
+        premier = anneau->nombre > TAILLE_TRACE ? anneau->nombre - TAILLE_TRACE : 0;
+        for (i = premier; i < anneau->nombre; i++) {
+            evenement = &anneau->evenements[i & (TAILLE_TRACE - 1)];
+            fprintf(fichier, ",\n{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%d", evenement->nom,
+                    evenement->phase, (evenement->date - origineDate) * nanosecondes / 1000.0, anneau->fil);
+            if (evenement->phase == 'i') {
+                fprintf(fichier, ",\"s\":\"t\"");
+            }
+            if (evenement->phase != 'B') {
+                fprintf(fichier, ",\"args\":{\"valeur\":%lld}", (long long)evenement->valeur);
+            }
+            fprintf(fichier, "}");
+        }
+    }
+    fprintf(fichier, "\n],\"displayTimeUnit\":\"ns\"}\n");
+    if (ferror(fichier)) {
+        fclose(fichier);
+        return false;
+    }
+    return fclose(fichier) == 0;
+}
+
+#endif
@@ -0,0 +1,129 @@
+/**
+* \file trace.h
+* \brief le traçage des évènements du jeu snake
+* \author Merrien Ethan
+* \version V4
+* \date 17/10/2026
+*
+* Compilés avec -DTRACE, les macros TRACE_* datent chaque évènement avec
+* le compteur de cycles du processeur et le rangent dans l'anneau du fil
+* qui l'émet : aucun verrou, aucune allocation après le premier évènement
+* du fil, quelques nanosecondes par évènement. Quand un anneau est plein,
+* les évènements les plus anciens sont remplacés. Sans -DTRACE, les macros
+* ne produisent aucun code et leurs arguments ne sont pas évalués.
+*
+* À la fin du programme, ecrireTrace() écrit tous les anneaux au format
+* JSON de Chrome, à ouvrir avec ui.perfetto.dev ou chrome://tracing :
+* chaque fil est une ligne, chaque paire TRACE_DEBUT / TRACE_FIN une
+* tranche et chaque TRACE_INSTANT un repère, avec sa valeur en argument.
+*
+* Un programme compilé avec -DTRACE doit l'être avec trace.c.
+*
+*/
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#ifdef TRACE
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+
+#define TAILLE_TRACE 65536 //constante pour le nombre d'évènements gardés par fil, une puissance de deux
+#define TRACE_ACTIVE 1 //constante qui indique que le programme est compilé avec -DTRACE
+
+/**
+ * \brief Un évènement tracé.
+ */
+typedef struct {
+    uint64_t date;     // compteur de cycles au moment de l'évènement
+    const char *nom;   // nom de l'évènement, une chaîne littérale sans guillemet
+    int64_t valeur;    // valeur affichée en argument
+    char phase;        // 'B' début de tranche, 'E' fin de tranche, 'i' repère
+} t_evenement;
+
+/**
+ * \brief Anneau des derniers évènements d'un fil.
+ */
+typedef struct t_anneau {
+    t_evenement evenements[TAILLE_TRACE];
+    uint64_t nombre;           // évènements émis depuis le début, le suivant va en nombre % TAILLE_TRACE
+    int fil;                   // numéro du fil dans la trace
+    struct t_anneau *suivant;  // anneau du fil créé avant
+} t_anneau;
+
+extern _Thread_local t_anneau *anneauTrace;
+
+/**
+ * \brief Crée l'anneau du fil appelant et l'ajoute à la liste des anneaux écrits à la fin.
+ * \return L'anneau, ou NULL si la mémoire manque.
+ */
+t_anneau *creerAnneau();
+
+/**
+ * \brief Donne la date d'un évènement.
+ * \return Le compteur de cycles du processeur, ou l'horloge monotone en nanosecondes ailleurs que sur x86.
+ */
+static inline uint64_t dateTrace(){
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec t;
+
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+#endif
+}
+
+/**
+ * \brief Range un évènement dans l'anneau du fil appelant.
+ * \param nom Nom de l'évènement, une chaîne littérale.
+ * \param phase 'B', 'E' ou 'i'.
+ * \param valeur Valeur de l'évènement.
+ */
+static inline void tracer(const char *nom, char phase, int64_t valeur){
+    t_anneau *anneau = anneauTrace;
+    t_evenement *evenement;
+
+    if (anneau == NULL && (anneau = creerAnneau()) == NULL) {
+        return; // Sans mémoire, les évènements du fil sont perdus
+    }
+    evenement = &anneau->evenements[anneau->nombre++ & (TAILLE_TRACE - 1)];
+    evenement->date = dateTrace();
+    evenement->nom = nom;
+    evenement->valeur = valeur;
+    evenement->phase = phase;
+}
+
+/**
+ * \brief Écrit les évènements de tous les fils au format JSON de Chrome.
+ *
+ * Les fils qui ont tracé doivent être terminés, ou ne plus rien tracer.
+ *
+ * \param chemin Chemin du fichier.
+ * \return false en cas d'erreur (errno indique pourquoi).
+ */
+bool ecrireTrace(const char *chemin);
+
+#define TRACE_DEBUT(nom) tracer(nom, 'B', 0)
+#define TRACE_FIN(nom, valeur) tracer(nom, 'E', (int64_t)(valeur))
+#define TRACE_INSTANT(nom, valeur) tracer(nom, 'i', (int64_t)(valeur))
+#define TRACE_ECRIRE(chemin) ecrireTrace(chemin)
+
+#else
+
+#define TRACE_ACTIVE 0 //constante qui indique que le programme est compilé sans -DTRACE
+
+#define TRACE_DEBUT(nom) ((void)0)
+#define TRACE_FIN(nom, valeur) ((void)0)
+#define TRACE_INSTANT(nom, valeur) ((void)0)
+#define TRACE_ECRIRE(chemin) true
+
+#endif
+
+#endif
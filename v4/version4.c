@@ -6,441 +6,802 @@
 * \date 18/11/2024
 *
 * Dans cette quatrième version,
-* le serpent commence à la position 40,20 et progresse vers la droite,
+* le serpent commence au centre du plateau et progresse vers la droite,
 * sa progression peut changer de direction avec les touches q, z, s, d,
 * le serpent arrête sa progression lorsque l'utilisateur appuie sur la touche "a"
 * Ou lorsqu'il rentre en collision avec lui-même, un pavé ou les bordures.
 * Sauf si il sort par les espaces de la bordure
 * L'utilisateur peut gagner la partie en mangeant 10 pommes
+* La taille du plateau, la taille du serpent au départ et le nombre de pommes
+* à manger se choisissent au lancement.
+*
+* Ce fichier gère le clavier, l'horloge et la boucle principale,
+* les règles sont dans moteur.c et l'affichage dans affichage.c.
+* Compilation : gcc -o version4 version4.c moteur.c affichage.c alea.c journal.c autopilote.c diffusion.c histogramme.c trace.c
+* Utilisation : ./version4 [--tps ticks_par_seconde] [--graine graine] [--enregistrer journal]
+*                          [--paves nombre] [--taille-pave cote] [--largeur largeur] [--hauteur hauteur]
+*                          [--taille taille_serpent] [--objectif pommes] [--bits] [--auto]
+*                          [--diffuser socket] [--stats] [--stats-fichier fichier] [--trace fichier]
+*               ./version4 --rejouer journal [--rapide] [--bits] [--diffuser socket] [--stats] [--stats-fichier fichier]
+*                          [--trace fichier]
+*
+* --enregistrer écrit la graine et les touches de la partie dans un journal,
+* --rejouer rejoue un journal à la vitesse d'origine, ou sans attendre avec --rapide.
+* --bits stocke le plateau en plans de bits, pour les très grands plateaux.
+* --auto confie la direction au pilote automatique (autopilote.c), seules les
+* touches d'arrêt et de pause restent actives ; ses directions sont enregistrées
+* comme des touches, le journal se rejoue donc sans pilote.
+* --diffuser publie la partie sur une socket Unix, à suivre avec spectateur.c.
+* --stats mesure chaque phase de la boucle principale (lecture des touches,
+* progression, nouvelle pomme, trame, retard au réveil) ainsi que le délai
+* entre l'arrivée d'une touche et la trame qui la montre, et affiche à la fin
+* leurs centiles avec les compteurs de l'affichage, de la simulation, du pilote
+* et de la diffusion ; sans --stats, seule la graine suit le résultat.
+* --stats-fichier écrit en plus les histogrammes dans un fichier.
+* Pour dater les touches à leur arrivée, l'attente surveille alors aussi le clavier.
+* --trace, pour un programme compilé avec -DTRACE, écrit à la fin une trace de
+* Chrome des ticks, attentes, trames, écritures, touches lues et pommes (trace.h).
+* Un plateau plus grand que le terminal est affiché par une vue qui suit la tête.
 *
 */
 #include <stdio.h>
 #include <stdlib.h>
 #include <unistd.h>
-#include <fcntl.h>
 #include <termios.h>
 #include <string.h>
+#include <limits.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <time.h>
+#include <errno.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/ioctl.h>
+
+#include "moteur.h"
+#include "affichage.h"
+#include "journal.h"
+#include "autopilote.h"
+#include "diffusion.h"
+#include "histogramme.h"
+#include "trace.h"
+
+#define TAILLE_CLAVIER 64 //constante pour le nombre de touches en attente
+#define PERIODE_AFFICHAGE 16666667 //constante pour la durée minimale entre deux trames (60 images par seconde)
+#define RATTRAPAGE_MAX 8 //constante pour le nombre de ticks en retard que la simulation peut rattraper
+#define MESURE_ENTREE 0 //constante pour la mesure de la lecture des touches
+#define MESURE_PROGRESSION 1 //constante pour la mesure de progresser()
+#define MESURE_POMME 2 //constante pour la mesure de ajouterPomme()
+#define MESURE_TRAME 3 //constante pour la mesure de dessinerTrame()
+#define MESURE_REVEIL 4 //constante pour la mesure du retard au réveil
+#define MESURE_TOUCHE 5 //constante pour la mesure du délai entre une touche et sa trame
+#define NB_MESURES 6 //constante pour le nombre de mesures de --stats
 
-#define MAXTAB_X 80 //constante pour la Taille Max d’un tableau
-#define MAXTAB_Y 40
-#define MINTAB 1 //constante pour la Taille Min d’un tableau
-#define TAILLE_SERPENT 10 //constante pour la Taille du serpent
-#define DEPARTX 40 //constante pour la position de départ
-#define DEPARTY 20
-#define ARRET 'a' //constante pour la touche d'arret du programme
-#define TETE 'O' //constante pour la tete du serpent
-#define ANNEAUX 'X' //constante pour les anneaux du serpent
-#define HAUT 'z' //constante pour la touche de direction "haut"
-#define BAS 's' //constante pour la touche de direction "bas"
-#define GAUCHE 'q' //constante pour la touche de direction "gauche"
-#define DROITE 'd' //constante pour la touche de direction "droite"
-#define BORDURE '#' //constante pour les bordures du plateau de jeu
-#define ESPACE ' ' //constante pour le l'intérieure des bordures du plateau
-#define POMME '6' //constante pour le caractère des pommes
-#define MAXPOMME 10 //constante pour le nombre de pommes à mangé pour gagner
-
-char plateau[MAXTAB_Y][MAXTAB_X];
-int tailleActuelle;
+/**
+ * \brief État du clavier.
+ *
+ * Le terminal passe une seule fois en mode non canonique sans écho,
+ * les touches lues sont gardées ici jusqu'à leur traitement.
+ */
+typedef struct {
+    struct termios ancien;         // réglages du terminal à restaurer
+    bool actif;                    // le terminal est en mode non canonique
+    char touches[TAILLE_CLAVIER];  // touches lues et pas encore traitées
+    int debut;                     // indice de la prochaine touche à traiter
+    int fin;                       // indice de fin des touches en attente
+    int64_t dateLecture;           // date de lecture des touches en attente
+} t_clavier;
 
 /**
- * \brief Affiche un caractère à une position donnée.
- * \param x Position en abscisse.
- * \param y Position en ordonnée.
- * \param c Caractère à afficher.
+ * \brief Horloge du jeu à pas fixe.
+ *
+ * Les ticks sont programmés à des dates absolues de l'horloge monotone,
+ * le temps passé à calculer et afficher une trame ne décale donc pas les suivants.
  */
-void afficher(int x, int y, char c);
+typedef struct {
+    int64_t periode;      // durée d'un tick en nanosecondes
+    int64_t echeance;     // date absolue du prochain tick
+    int rattrapage;       // nombre de ticks en retard rattrapés avant d'en sauter
+    long ticks;           // nombre de ticks écoulés
+    long depassements;    // nombre de ticks manqués car la trame a pris trop de temps
+    int64_t gigueMax;     // plus grand retard au réveil, en nanosecondes
+    int64_t gigueTotale;  // somme des retards au réveil, en nanosecondes
+} t_horloge;
+
+t_clavier clavier;
+const char *nomsMesures[NB_MESURES] = { "entree", "progression", "pomme", "trame", "reveil", "touche" };
+t_histogramme *mesures = NULL; // histogrammes de --stats, NULL sans mesures
 
-void gotoXY(int x, int y);
+/**
+ * \brief Passe le terminal en mode non canonique sans écho jusqu'à la fin du programme.
+ *
+ * Les réglages d'origine sont restaurés à la sortie du programme
+ * ainsi qu'à la réception d'un signal d'arrêt.
+ */
+void initClavier();
+
+/**
+ * \brief Restaure les réglages d'origine du terminal.
+ */
+void restaurerClavier();
 
 /**
- * \brief Efface le caractère à une position donnée.
- * \param x Position en abscisse.
- * \param y Position en ordonnée.
+ * \brief Restaure le terminal puis termine le programme à la réception d'un signal.
+ * \param signal Le signal reçu.
+ */
+void signalArret(int signal);
+
+/**
+ * \brief Indique si une touche est disponible, en attendant au plus le délai donné.
+ *
+ * Si aucune touche n'est en attente, l'entrée est surveillée avec poll()
+ * puis toutes les touches disponibles sont lues en un seul read().
+ *
+ * \param attente Délai maximum en millisecondes (-1 pour attendre sans limite).
+ * \return true si une touche peut être lue avec lireTouche().
+ */
+bool toucheDisponible(int attente);
+
+/**
+ * \brief Retire la prochaine touche en attente.
+ * \return La touche.
+ */
+char lireTouche();
+
+/**
+ * \brief Donne la place disponible pour la vue du plateau dans le terminal.
+ *
+ * Le compteur de pommes garde LARGEUR_COMPTEUR colonnes à droite de la vue.
+ *
+ * \param colonnes Nombre de colonnes disponibles, 0 si la taille du terminal est inconnue.
+ * \param lignes Nombre de lignes disponibles, 0 si la taille du terminal est inconnue.
  */
-void effacer(int x, int y);
+void tailleTerminal(int *colonnes, int *lignes);
 
 /**
- * \brief Dessine le serpent sur le champ de jeu.
- * \param lesX Tableau des positions x de chaque segment du serpent.
- * \param lesY Tableau des positions y de chaque segment du serpent.
+ * \brief Donne la date actuelle de l'horloge monotone.
+ * \return La date en nanosecondes.
  */
-void dessinerSerpent(int lesX[], int lesY[]);
+int64_t maintenant();
 
 /**
- * \brief Met à jour la position du serpent dans la direction indiquée.
- * \param lesX Tableau des positions x de chaque segment du serpent.
- * \param lesY Tableau des positions y de chaque segment du serpent.
- * \param direction Direction actuelle du serpent.
- * \param Collision Collision avec un élement du plateau ou le serpent lui-même.
+ * \brief Donne la date de début d'une mesure.
+ * \return La date actuelle, ou 0 sans --stats.
  */
-void progresser(int lesX[], int lesY[], char direction, bool *collision, bool *pomme);
+int64_t debutMesure();
 
 /**
- * \brief Désactive l'affichage des caractères tapés dans le terminal.
+ * \brief Compte la durée d'une mesure dans son histogramme, si --stats est actif.
+ * \param mesure La mesure, MESURE_*.
+ * \param debut La date de début rendue par debutMesure().
  */
-void disableEcho();
+void finMesure(int mesure, int64_t debut);
 
 /**
- * \brief Réactive l'affichage des caractères tapés dans le terminal.
+ * \brief Affiche les centiles de chaque mesure et les écrit dans un fichier si demandé.
+ * \param chemin Chemin du fichier des histogrammes, NULL pour ne rien écrire.
  */
-void enableEcho();
+void afficherMesures(const char *chemin);
 
 /**
- * \brief Initialise les elements de plateau de jeu donner en paramètres.
+ * \brief Démarre l'horloge, le premier tick a lieu une période plus tard.
+ * \param horloge L'horloge.
+ * \param periode Durée d'un tick en nanosecondes.
+ * \param rattrapage Nombre de ticks en retard rattrapés avant d'en sauter.
+ */
+void initHorloge(t_horloge *horloge, int64_t periode, int rattrapage);
+
+/**
+ * \brief Attend une date absolue de l'horloge monotone.
+ * \param date La date en nanosecondes.
+ */
+void attendreJusqua(int64_t date);
+
+/**
+ * \brief Attend une date absolue en lisant les touches dès leur arrivée.
  *
- * \param plateau Le plateau de jeu
- * \param lesX la position du serpent en abscisses
- * \param lesY la position du serpent en ordonnées
+ * Tant qu'aucune touche n'est en attente, le clavier est surveillé à la
+ * milliseconde près pour que dateLecture soit la date d'arrivée des
+ * touches ; la fin de l'attente est précise comme attendreJusqua().
+ *
+ * \param date La date en nanosecondes.
  */
-void initPlateau(char plateau[MAXTAB_Y][MAXTAB_X], int lesX[], int lesY[]);
+void attendreClavier(int64_t date);
 
 /**
- * \brief Affiche les elements de plateau de jeu donner en paramètres.
+ * \brief Indique si un tick est dû à la date donnée et programme alors le suivant.
+ *
+ * Tant que le retard ne dépasse pas le rattrapage autorisé, les ticks dus
+ * sont rendus un par un. Au-delà, les ticks dont la date est passée sont
+ * comptés comme manqués au lieu d'être enchaînés.
  *
- * \param plateau Le plateau de jeu
+ * \param horloge L'horloge.
+ * \param date La date actuelle en nanosecondes.
+ * \return true si un tick doit être exécuté.
+ */
+bool tickDu(t_horloge *horloge, int64_t date);
+
+/**
+ * \brief Change la durée des ticks, à partir du prochain.
+ * \param horloge L'horloge.
+ * \param periode Nouvelle durée d'un tick en nanosecondes.
  */
-void dessinerPlateau(char plateau[MAXTAB_Y][MAXTAB_X]);
+void changerPeriode(t_horloge *horloge, int64_t periode);
 
-void ajouterPomme(int lesX[], int lesY[]);
+/**
+ * \brief Reprogramme le prochain tick une période après maintenant, par exemple après une pause.
+ * \param horloge L'horloge.
+ */
+void reprendreHorloge(t_horloge *horloge);
 
-int kbhit();
+/**
+ * \brief Lit la valeur entière d'une option, ou arrête le programme avec un message qui nomme l'option.
+ * \param programme Nom du programme.
+ * \param option Nom de l'option.
+ * \param texte Valeur donnée à l'option.
+ * \param min Plus petite valeur acceptée.
+ * \param max Plus grande valeur acceptée.
+ * \return La valeur lue.
+ */
+int lireOption(const char *programme, const char *option, const char *texte, int min, int max);
 
-int main()
+int main(int argc, char *argv[])
 {
-    int i;
-    int lesX[TAILLE_SERPENT + MAXPOMME], lesY[TAILLE_SERPENT + MAXPOMME];
-    char cle = DROITE; // Direction actuelle
-    char ancienneCle = DROITE;
+    int i, ancienneTete, colonnes, lignes;
+    t_partie *partie;
+    const char *erreur;
+    t_resultat resultat = { 0 };
+    char cle = DROITE; // Direction demandée
     char nouvelleCle = ' ';
-    int temporisation = 200000;
-    int pommeMange = 0;
-    bool collision = false;
+    t_horloge simulation, affichage;
+    int64_t periodeFixe = 0; // Durée d'un tick imposée en ligne de commande
+    long tps;
+    bool toucheLue;
+    char *finNombre;
+    int64_t date;
+    int pommeAffichee = 0; // Valeur actuellement affichée du compteur
+    uint64_t graine = (uint64_t)time(NULL) ^ (uint64_t)maintenant(); // Graine tirée au hasard sauf si imposée
+    const char *cheminEnregistrement = NULL;
+    const char *cheminRejeu = NULL;
+    bool rapide = false; // Le rejeu enchaîne les ticks sans attendre
+    t_enregistreur enregistreur;
+    int erreurJournal = 0; // errno de l'écriture du journal qui a échoué, 0 sans erreur
+    t_lecteur lecteur;
+    long tick = 0; // Nombre de ticks déjà simulés
+    t_config config = configDefaut;
+    bool automatique = false; // La direction est choisie par le pilote automatique
+    t_autopilote *pilote = NULL;
+    const char *cheminDiffusion = NULL;
+    t_diffusion *diffusion = NULL;
+    bool stats = false;
+    const char *cheminStats = NULL;
+    const char *cheminTrace = NULL;
+    int64_t debut;
+    int64_t dateTouche = 0; // Arrivée de la plus ancienne touche pas encore affichée, 0 si aucune
+
+    for (i = 1; i < argc; i++) { // Lecture des options
+        if (strcmp(argv[i], "--tps") == 0 && i + 1 < argc) { // Nombre de ticks par seconde imposé
+            tps = strtol(argv[++i], &finNombre, 10);
+            if (*finNombre != '\0' || tps <= 0 || tps > 1000000000) { // Au plus un tick par nanoseconde
+                fprintf(stderr, "%s : --tps attend un nombre de ticks par seconde entre 1 et 1000000000\n", argv[0]);
+                return EXIT_FAILURE;
+            }
+            periodeFixe = 1000000000 / tps;
+        }
+        else if (strcmp(argv[i], "--graine") == 0 && i + 1 < argc) { // Graine imposée pour rejouer le même plateau
+            if (!lireGraine(argv[++i], &graine)) {
+                fprintf(stderr, "%s : --graine attend un entier entre 0 et %llu, pas « %s »\n", argv[0],
+                        (unsigned long long)UINT64_MAX, argv[i]);
+                return EXIT_FAILURE;
+            }
+        }
+        else if (strcmp(argv[i], "--paves") == 0 && i + 1 < argc) {
+            config.nbPaves = lireOption(argv[0], "--paves", argv[++i], 0, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--taille-pave") == 0 && i + 1 < argc) {
+            config.taillePave = lireOption(argv[0], "--taille-pave", argv[++i], 0, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--largeur") == 0 && i + 1 < argc) {
+            config.largeur = lireOption(argv[0], "--largeur", argv[++i], MINI_PLATEAU, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--hauteur") == 0 && i + 1 < argc) {
+            config.hauteur = lireOption(argv[0], "--hauteur", argv[++i], MINI_PLATEAU, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--taille") == 0 && i + 1 < argc) {
+            config.tailleSerpent = lireOption(argv[0], "--taille", argv[++i], 1, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--objectif") == 0 && i + 1 < argc) {
+            config.objectif = lireOption(argv[0], "--objectif", argv[++i], 1, INT_MAX);
+        }
+        else if (strcmp(argv[i], "--bits") == 0) {
+            config.stockage = STOCKAGE_BITS;
+        }
+        else if (strcmp(argv[i], "--enregistrer") == 0 && i + 1 < argc) {
+            cheminEnregistrement = argv[++i];
+        }
+        else if (strcmp(argv[i], "--rejouer") == 0 && i + 1 < argc) {
+            cheminRejeu = argv[++i];
+        }
+        else if (strcmp(argv[i], "--rapide") == 0) {
+            rapide = true;
+        }
+        else if (strcmp(argv[i], "--auto") == 0) {
+            automatique = true;
+        }
+        else if (strcmp(argv[i], "--diffuser") == 0 && i + 1 < argc) {
+            cheminDiffusion = argv[++i];
+        }
+        else if (strcmp(argv[i], "--stats") == 0) {
+            stats = true;
+        }
+        else if (strcmp(argv[i], "--stats-fichier") == 0 && i + 1 < argc) {
+            stats = true;
+            cheminStats = argv[++i];
+        }
+        else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            cheminTrace = argv[++i];
+        }
+        else {
+            fprintf(stderr, "usage : %s [--tps ticks_par_seconde] [--graine graine] [--enregistrer journal]\n"
+                            "        %*s [--paves nombre] [--taille-pave cote] [--largeur largeur] [--hauteur hauteur]\n"
+                            "        %*s [--taille taille_serpent] [--objectif pommes] [--bits] [--auto]\n"
+                            "        %*s [--diffuser socket] [--stats] [--stats-fichier fichier] [--trace fichier]\n"
+                            "        %s --rejouer journal [--rapide] [--bits] [--diffuser socket]\n"
+                            "        %*s [--stats] [--stats-fichier fichier] [--trace fichier]\n",
+                    argv[0], (int)strlen(argv[0]), "", (int)strlen(argv[0]), "", (int)strlen(argv[0]), "", argv[0],
+                    (int)strlen(argv[0]) + 18, "");
+            return EXIT_FAILURE;
+        }
+    }
+    if (cheminRejeu != NULL && cheminEnregistrement != NULL) {
+        fprintf(stderr, "%s : --rejouer et --enregistrer ne peuvent pas être utilisés ensemble\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (cheminRejeu != NULL && automatique) {
+        fprintf(stderr, "%s : --rejouer et --auto ne peuvent pas être utilisés ensemble\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    if (cheminTrace != NULL && !TRACE_ACTIVE) {
+        fprintf(stderr, "%s : --trace demande un programme compilé avec -DTRACE\n", argv[0]);
+        return EXIT_FAILURE;
+    }
+    rapide = rapide && cheminRejeu != NULL;
 
-    lesX[0] = DEPARTX; //coordonnées de départ du sepent
-    lesY[0] = DEPARTY;
+    if (cheminRejeu != NULL) { // La graine et la vitesse viennent du journal
+        if (!ouvrirLecture(&lecteur, cheminRejeu)) {
+            return EXIT_FAILURE;
+        }
+        graine = lecteur.graine;
+        periodeFixe = lecteur.periodeFixe;
+        lecteur.config.stockage = config.stockage; // Le stockage n'est pas dans le journal
+        config = lecteur.config;
+    }
+    erreur = erreurConfig(&config);
+    if (erreur != NULL) {
+        fprintf(stderr, "%s : %s\n", argv[0], erreur);
+        return EXIT_FAILURE;
+    }
+    if (cheminEnregistrement != NULL && !ouvrirEnregistrement(&enregistreur, cheminEnregistrement, graine, 0, periodeFixe, &config)) {
+        return EXIT_FAILURE;
+    }
 
-    for (i = 1; i < TAILLE_SERPENT; i++) { //initialise les positions du serpent
-        lesX[i] = lesX[0] - i;
-        lesY[i] = lesY[0];
+    partie = partieCreer(&config, graine, cheminRejeu != NULL ? lecteur.flux : 0);
+    if (partie == NULL) {
+        perror("partieCreer");
+        return EXIT_FAILURE;
+    }
+    if (automatique) {
+        pilote = autopiloteCreer(partie);
+        if (pilote == NULL) {
+            perror("autopiloteCreer");
+            return EXIT_FAILURE;
+        }
+    }
+    if (cheminDiffusion != NULL) {
+        diffusion = diffusionCreer(cheminDiffusion, partie);
+        if (diffusion == NULL) {
+            perror(cheminDiffusion);
+            return EXIT_FAILURE;
+        }
+    }
+    if (stats) { // Les histogrammes sont alloués une fois, les mesures n'allouent plus rien
+        mesures = malloc(NB_MESURES * sizeof(t_histogramme));
+        if (mesures == NULL) {
+            perror("malloc");
+            return EXIT_FAILURE;
+        }
+        for (i = 0; i < NB_MESURES; i++) {
+            initHistogramme(&mesures[i]);
+        }
     }
     
     system("clear");
 
-    initPlateau(plateau, lesX, lesY);
-    dessinerPlateau(plateau);
-
-    tailleActuelle = TAILLE_SERPENT;
-
-    disableEcho();
-    ajouterPomme(lesX, lesY);
-    while (cle != ARRET && collision == false && pommeMange < MAXPOMME) {  //Boucle principale 
-        bool pomme = false;
-        for (i = 0; i < tailleActuelle; i++) { //Boucle permettant d'effacer l'ancienne position du serpent
-            effacer(lesX[i], lesY[i]);
+    tailleTerminal(&colonnes, &lignes);
+    initAffichage(STDOUT_FILENO, partie, colonnes, lignes);
+    dessinerVue(partie); // L'écran est vide : seules les cases non vides sont envoyées
+    dessinerCompteur(partie);
+    dessinerMemoire(partie);
+    finTrame();
+
+    initClavier();
+    initHorloge(&simulation, periodeFixe > 0 ? periodeFixe : periodeTick(partie->pommeMange), RATTRAPAGE_MAX);
+    initHorloge(&affichage, PERIODE_AFFICHAGE, 0);
+    while (cle != ARRET && resultat.collision == false && resultat.gagne == false) {  //Boucle principale 
+        // Attendre le prochain tick de simulation ou la prochaine trame
+        date = simulation.echeance < affichage.echeance ? simulation.echeance : affichage.echeance;
+        if (rapide == false) {
+            TRACE_DEBUT("attente");
+            if (mesures != NULL) {
+                attendreClavier(date);
+            }
+            else {
+                attendreJusqua(date);
+            }
+            debut = date;
+            date = maintenant();
+            finMesure(MESURE_REVEIL, debut);
+            TRACE_FIN("attente", date - debut); // Le retard au réveil
         }
-        gotoXY(90, 20);
-        printf("Pomme mangées: %d", pommeMange);
 
-        progresser(lesX, lesY, cle, &collision, &pomme);
+        while (cle != ARRET && resultat.collision == false && resultat.gagne == false && tickDu(&simulation, date)) {
+            // La lecture est mesurée à chaque tick, qu'une touche soit là ou non
+            debut = debutMesure();
+            toucheLue = toucheDisponible(0);
+            if (toucheLue) {
+                nouvelleCle = lireTouche();
+            }
+            finMesure(MESURE_ENTREE, debut);
+            if (toucheLue){ 
+                if (nouvelleCle == PAUSE) { // Afficher l'état courant avant de se mettre en pause
+                    dessinerTrame(partie, &pommeAffichee);
+                    if (cheminEnregistrement != NULL) {
+                        enregistrerTouche(&enregistreur, tick, PAUSE);
+                    }
+                }
+                while(nouvelleCle == PAUSE){
+                    // La pause attend la prochaine touche sans consommer de temps processeur,
+                    // en se réveillant à chaque trame pour continuer à servir les spectateurs
+                    if (toucheDisponible(diffusion != NULL ? PERIODE_AFFICHAGE / 1000000 : -1)){
+                        nouvelleCle = lireTouche();
+                    }
+                    else if (diffusion != NULL) {
+                        servirSpectateurs(diffusion, partie);
+                    }
+                    reprendreHorloge(&simulation);
+                    reprendreHorloge(&affichage);
+                }
+                // Pendant un rejeu ou avec le pilote, seul l'arrêt est accepté
+                if ((cheminRejeu == NULL && pilote == NULL) || nouvelleCle == ARRET) {
+                    cle = nouvelleCle; // Le moteur ignore les directions opposées
+                    if (dateTouche == 0) {
+                        dateTouche = clavier.dateLecture;
+                    }
+                }
+                if (cheminEnregistrement != NULL && (pilote == NULL || nouvelleCle == ARRET)) {
+                    enregistrerTouche(&enregistreur, tick, nouvelleCle);
+                }
+            }
+            while (cheminRejeu != NULL && cle != ARRET && toucheRejouee(&lecteur, tick, &nouvelleCle)) {
+                if (nouvelleCle != PAUSE) { // La pause n'a pas d'effet sur la partie
+                    cle = nouvelleCle;
+                }
+            }
+            if (cle == ARRET) {
+                break;
+            }
+            if (pilote != NULL) { // Le journal ne retient que les changements de direction
+                nouvelleCle = choisirChemin(pilote, partie);
+                if (cheminEnregistrement != NULL && nouvelleCle != cle) {
+                    enregistrerTouche(&enregistreur, tick, nouvelleCle);
+                }
+                cle = nouvelleCle;
+            }
 
-        if (pomme == true){
-            temporisation = temporisation - 15000;
-            pommeMange++;
-            tailleActuelle++;
-            ajouterPomme(lesX, lesY);
+            // Comme avancerPartie(), en deux temps pour mesurer la nouvelle pomme à part
+            TRACE_DEBUT("tick");
+            ancienneTete = lireSegment(&partie->serpent, 0);
+            debut = debutMesure();
+            progresser(partie, cle, &resultat);
+            finMesure(MESURE_PROGRESSION, debut);
+            if (resultat.pomme && !resultat.gagne) {
+                debut = debutMesure();
+                resultat.gagne = !ajouterPomme(partie); // Plus aucune case libre pour une pomme
+                finMesure(MESURE_POMME, debut);
+            }
+            tick++;
+            marquerProgression(partie, ancienneTete, &resultat);
+            if (diffusion != NULL) {
+                diffuserTick(diffusion, partie, &resultat);
+            }
+            TRACE_FIN("tick", tick);
 
+            if (resultat.pomme == true && periodeFixe == 0){
+                changerPeriode(&simulation, periodeTick(partie->pommeMange));
+            }
         }
-        
-        dessinerSerpent(lesX, lesY);
 
-        usleep(temporisation);
-
-        if (kbhit()){ 
-            nouvelleCle = getchar();
-            while(nouvelleCle == 'p'){
-                usleep(temporisation);
-                if (kbhit()){ 
-                    nouvelleCle = getchar();
-                }
-            }
-            if ((nouvelleCle == DROITE && ancienneCle != GAUCHE) || // Boucle pour empêcher les directions opposées
-                (nouvelleCle == GAUCHE && ancienneCle != DROITE) ||
-                (nouvelleCle == HAUT && ancienneCle != BAS) ||
-                (nouvelleCle == BAS && ancienneCle != HAUT) || 
-                (nouvelleCle == ARRET)) {
-                cle = nouvelleCle;  // Met à jour la direction uniquement si elle n'est pas opposée
+        if (tickDu(&affichage, date)) { // Les ticks écoulés depuis la dernière trame forment un seul delta
+            debut = debutMesure();
+            TRACE_DEBUT("trame");
+            dessinerTrame(partie, &pommeAffichee);
+            TRACE_FIN("trame", tampon.trames);
+            finMesure(MESURE_TRAME, debut);
+            if (dateTouche != 0) { // La trame montre l'effet des touches prises en compte
+                finMesure(MESURE_TOUCHE, dateTouche);
+                dateTouche = 0;
             }
         }
-        ancienneCle = cle;
+        if (diffusion != NULL) { // Nouveaux spectateurs et messages en attente, sans attendre
+            servirSpectateurs(diffusion, partie);
+        }
+    }
+    dessinerTrame(partie, &pommeAffichee);
+    restaurerClavier();
+    if (cheminEnregistrement != NULL && !fermerEnregistrement(&enregistreur)) {
+        erreurJournal = errno != 0 ? errno : EIO; // Signalée après le résultat, que l'effacement de l'écran cacherait
+    }
+    if (cheminRejeu != NULL) {
+        fermerLecture(&lecteur);
     }
-    enableEcho();
     system("clear");
-    if(pommeMange == MAXPOMME){
+    if(resultat.gagne){
         printf("YOU WIN !");
     }
     else{
         printf("GAME OVER !");
     }
+    printf("\nGraine : %llu\n", (unsigned long long)graine);
+    if (stats) { // Les compteurs accompagnent les centiles, la fin de partie reste celle d'origine sans --stats
+        printf("Mémoire : %.1f Mo pour un plateau de %dx%d\n", partie->memoire / 1048576.0,
+               config.largeur, config.hauteur);
+        printf("Affichage : %ld trames, %.1f octets et %.2f appels à write() par trame, %ld déplacements de la vue\n",
+               tampon.trames, (double)tampon.octetsTotal / tampon.trames,
+               (double)tampon.appelsTotal / tampon.trames, vue.deplacements);
+        printf("Simulation : %ld ticks, gigue moyenne %.1f µs, gigue max %.1f µs, %ld ticks manqués\n",
+               simulation.ticks, simulation.ticks > 0 ? simulation.gigueTotale / 1000.0 / simulation.ticks : 0.0,
+               simulation.gigueMax / 1000.0, simulation.depassements);
+        if (pilote != NULL) {
+            printf("Pilote : %ld décisions (%ld vers la pomme, %ld vers la queue, %ld sans chemin), "
+                   "%.1f µs en moyenne, %.1f µs au plus par tick\n",
+                   pilote->decisions, pilote->versPomme, pilote->versQueue, pilote->secours,
+                   pilote->decisions > 0 ? pilote->dureeTotale / 1000.0 / pilote->decisions : 0.0,
+                   pilote->dureeMax / 1000.0);
+        }
+        if (diffusion != NULL) {
+            printf("Diffusion : %ld spectateurs, %ld images et %ld deltas envoyés, %ld décrochages, %.1f Ko\n",
+                   diffusion->connexions, diffusion->images, diffusion->deltas, diffusion->decrochages,
+                   diffusion->octets / 1024.0);
+        }
+        afficherMesures(cheminStats);
+        free(mesures);
+    }
+    if (pilote != NULL) {
+        autopiloteDetruire(pilote);
+    }
+    if (diffusion != NULL) {
+        diffusionDetruire(diffusion);
+    }
+    if (cheminTrace != NULL && !TRACE_ECRIRE(cheminTrace)) {
+        perror(cheminTrace);
+    }
+    partieDetruire(partie);
+    if (erreurJournal != 0) {
+        fprintf(stderr, "%s : %s, le journal est incomplet\n", cheminEnregistrement, strerror(erreurJournal));
+        return EXIT_FAILURE;
+    }
     return EXIT_SUCCESS;
 }
 
+void initClavier() {
+    struct termios tty;
+    struct sigaction action;
 
-int kbhit(){
-	// la fonction retourne :
-	// 1 si un caractere est present
-	// 0 si pas de caractere present
-	
-	int unCaractere=0;
-	struct termios oldt, newt;
-	int ch;
-	int oldf;
-
-	// mettre le terminal en mode non bloquant
-	tcgetattr(STDIN_FILENO, &oldt);
-	newt = oldt;
-	newt.c_lflag &= ~(ICANON | ECHO);
-	tcsetattr(STDIN_FILENO, TCSANOW, &newt);
-	oldf = fcntl(STDIN_FILENO, F_GETFL, 0);
-	fcntl(STDIN_FILENO, F_SETFL, oldf | O_NONBLOCK);
- 
-	ch = getchar();
-
-	// restaurer le mode du terminal
-	tcsetattr(STDIN_FILENO, TCSANOW, &oldt);
-	fcntl(STDIN_FILENO, F_SETFL, oldf);
- 
-	if(ch != EOF){
-		ungetc(ch, stdin);
-		unCaractere=1;
-	} 
-	return unCaractere;
-}
-
-void gotoXY(int x, int y) { 
-    printf("\033[%d;%df", y, x);
-}
-
-
-void dessinerSerpent(int lesX[], int lesY[]){
-    int i;
-
-    if (lesX[0] >= MINTAB && lesX[0] < MAXTAB_X && lesY[0] >= MINTAB && lesY[0] < MAXTAB_Y) { // Affiche la tête si elle est dans les limites
-        afficher(lesX[0], lesY[0], TETE);
+    // Sauvegarder les attributs du terminal
+    if (tcgetattr(STDIN_FILENO, &clavier.ancien) == -1) {
+        perror("tcgetattr");
+        exit(EXIT_FAILURE);
     }
 
-    for (i = 1; i < tailleActuelle; i++) { // Affiche les anneaux du corps si dans les limites
-        if (lesX[i] >= MINTAB && lesX[i] < MAXTAB_X && lesY[i] >= MINTAB && lesY[i] < MAXTAB_Y) {
-            afficher(lesX[i], lesY[i], ANNEAUX);
-        }
+    // Desactiver le mode canonique et l'écho
+    tty = clavier.ancien;
+    tty.c_lflag &= ~(ICANON | ECHO);
+    tty.c_cc[VMIN] = 1;
+    tty.c_cc[VTIME] = 0;
+    if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1) {
+        perror("tcsetattr");
+        exit(EXIT_FAILURE);
     }
+    clavier.actif = true;
+    clavier.debut = 0;
+    clavier.fin = 0;
+
+    // Restaurer le terminal à la sortie, même interrompue par un signal
+    atexit(restaurerClavier);
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = signalArret;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+    sigaction(SIGHUP, &action, NULL);
+    sigaction(SIGQUIT, &action, NULL);
 }
 
-void afficher(int x, int y, char c){
-    gotoXY(x, y);
-    printf("%c", c);
+void restaurerClavier() {
+    if (clavier.actif) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &clavier.ancien);
+        clavier.actif = false;
+    }
 }
 
-void progresser(int lesX[], int lesY[], char Direction, bool *collision, bool *pomme) {
-    int nouvelleTeteX = lesX[0];
-    int nouvelleTeteY = lesY[0];
+void signalArret(int signal) {
+    struct sigaction action;
 
-    // Calculer la nouvelle position selon la direction
-    if (Direction == DROITE) {
-        nouvelleTeteX += 1;
-    } else if (Direction == GAUCHE) {
-        nouvelleTeteX -= 1;
-    } else if (Direction == HAUT) {
-        nouvelleTeteY -= 1;
-    } else if (Direction == BAS) {
-        nouvelleTeteY += 1;
-    }
+    restaurerClavier();
 
-    if (plateau[nouvelleTeteY][nouvelleTeteX] == BORDURE){
-        *collision = true;
-    }
-    else{
-        // Gestion de la sortie par les bordures
-        if (nouvelleTeteX >= MAXTAB_X - 1) {  // Sortie par la droite
-            nouvelleTeteX = MINTAB;  // Réapparaît à gauche
-        } else if (nouvelleTeteX <= 0) {  // Sortie par la gauche
-            nouvelleTeteX = MAXTAB_X - 2;  // Réapparaît à droite
-        }
+    // Terminer le programme avec le comportement par défaut du signal
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_DFL;
+    sigaction(signal, &action, NULL);
+    raise(signal);
+}
 
-        if (nouvelleTeteY >= MAXTAB_Y - 1) {  // Sortie par le bas
-            nouvelleTeteY = MINTAB;  // Réapparaît en haut
-        } else if (nouvelleTeteY <= 0) {  // Sortie par le haut
-            nouvelleTeteY = MAXTAB_Y - 2;  // Réapparaît en bas
-        }
-    }
+bool toucheDisponible(int attente) {
+    struct pollfd entree = { .fd = STDIN_FILENO, .events = POLLIN };
+    ssize_t n;
 
-    // Vérifier les collisions avec le corps du serpent
-    for (int i = 0; i < tailleActuelle; i++) {
-        if (nouvelleTeteX == lesX[i] && nouvelleTeteY == lesY[i]) {
-            *collision = true;
-        }
+    if (clavier.debut < clavier.fin) { // Des touches sont déjà en attente
+        return true;
     }
-
-    // Vérifier si la tête rencontre une pomme
-    if (plateau[nouvelleTeteY][nouvelleTeteX] == POMME) {
-        *pomme = true;
+    clavier.debut = 0;
+    clavier.fin = 0;
+    if (poll(&entree, 1, attente) <= 0) {
+        return false;
     }
 
-    // Mettre à jour les positions du corps
-    for (int i = tailleActuelle - 1; i > 0; i--) {
-        lesX[i] = lesX[i - 1];
-        lesY[i] = lesY[i - 1];
+    n = read(STDIN_FILENO, clavier.touches, TAILLE_CLAVIER); // Lire toutes les touches disponibles
+    clavier.dateLecture = mesures != NULL ? maintenant() : 0;
+    TRACE_INSTANT("touches lues", n);
+    if (n == 0) { // L'entrée est fermée : on arrête la partie
+        clavier.touches[0] = ARRET;
+        n = 1;
     }
-
-    // Mettre à jour la tête
-    lesX[0] = nouvelleTeteX;
-    lesY[0] = nouvelleTeteY;
+    if (n < 0) {
+        return false;
+    }
+    clavier.fin = n;
+    return true;
 }
 
-void effacer(int x, int y)
-{
-    gotoXY(x, y);
-    printf(" ");
+char lireTouche() {
+    return clavier.touches[clavier.debut++];
 }
 
-void disableEcho() {
-    struct termios tty;
+void tailleTerminal(int *colonnes, int *lignes) {
+    struct winsize taille;
 
-    // Obtenir les attributs du terminalchar *plateau[MAXTAB_Y][MAXTAB_X]
-    if (tcgetattr(STDIN_FILENO, &tty) == -1) {
-        perror("tcgetattr");
-        exit(EXIT_FAILURE);
-    }
-
-    // Desactiver le flag ECHO
-    tty.c_lflag &= ~ECHO;
-
-    // Appliquer les nouvelles configurations
-    if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1) {
-        perror("tcsetattr");
-        exit(EXIT_FAILURE);
+    *colonnes = 0;
+    *lignes = 0;
+    if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &taille) == -1 || taille.ws_col == 0 || taille.ws_row == 0) {
+        return; // Pas un terminal : tout le plateau est affiché
     }
+    *colonnes = taille.ws_col > LARGEUR_COMPTEUR ? taille.ws_col - LARGEUR_COMPTEUR : 1;
+    *lignes = taille.ws_row;
 }
 
-void enableEcho() {
-    struct termios tty;
+int64_t maintenant(){
+    struct timespec t;
 
-    // Obtenir les attributs du terminal
-    if (tcgetattr(STDIN_FILENO, &tty) == -1) {
-        perror("tcgetattr");
-        exit(EXIT_FAILURE);
-    }
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (int64_t)t.tv_sec * 1000000000 + t.tv_nsec;
+}
 
-    // Reactiver le flag ECHO
-    tty.c_lflag |= ECHO;
+int64_t debutMesure(){
+    return mesures != NULL ? maintenant() : 0;
+}
 
-    // Appliquer les nouvelles configurations
-    if (tcsetattr(STDIN_FILENO, TCSANOW, &tty) == -1) {
-        perror("tcsetattr");
-        exit(EXIT_FAILURE);
+void finMesure(int mesure, int64_t debut){
+    if (mesures != NULL) {
+        ajouterValeur(&mesures[mesure], maintenant() - debut);
     }
 }
 
-void initPlateau(char plateau[MAXTAB_Y][MAXTAB_X], int lesX[], int lesY[]) {
-    int i, j, k, aleatX, aleatY;
-    srand(time(NULL));
+void afficherMesures(const char *chemin){
+    FILE *fichier;
+    int i;
 
-    // Initialiser les bords haut et bas
-    for (i = 0; i < MAXTAB_X; i++) {
-        if (i == MAXTAB_X / 2) {
-            plateau[0][i] = ESPACE; // Milieu
-            plateau[MAXTAB_Y - 1][i] = ESPACE;
-        }
-        else {
-            plateau[0][i] = BORDURE;
-            plateau[MAXTAB_Y - 1][i] = BORDURE;
-        }
+    printf("Mesures en µs :      nombre    médiane        p99      p99.9        max\n");
+    for (i = 0; i < NB_MESURES; i++) {
+        printf("  %-12s %12llu %10.1f %10.1f %10.1f %10.1f\n", nomsMesures[i],
+               (unsigned long long)mesures[i].nombre, centile(&mesures[i], 50) / 1000.0,
+               centile(&mesures[i], 99) / 1000.0, centile(&mesures[i], 99.9) / 1000.0, mesures[i].max / 1000.0);
     }
-
-    // Initialiser les bords gauche et droit, et les espaces intérieurs
-    for (j = MINTAB; j < MAXTAB_Y - 1; j++) {
-        if (j == MAXTAB_Y / 2) {
-            plateau[j][0] = ESPACE;
-            plateau[j][MAXTAB_X - 1] = ESPACE;
-        }
-        else {
-            plateau[j][0] = BORDURE;
-            plateau[j][MAXTAB_X - 1] = BORDURE;
-        }
-
-        for (i = 1; i < MAXTAB_X - 1; i++) {
-            plateau[j][i] = ESPACE; // Remplissage intérieur
+    if (chemin == NULL) {
+        return;
+    }
+    fichier = fopen(chemin, "w");
+    if (fichier == NULL) {
+        perror(chemin);
+        return;
+    }
+    for (i = 0; i < NB_MESURES; i++) {
+        if (!ecrireHistogramme(fichier, nomsMesures[i], &mesures[i])) {
+            perror(chemin);
+            break;
         }
     }
+    if (fclose(fichier) != 0) {
+        perror(chemin);
+    }
+}
 
-    // Créer 5 carrés aléatoires
-    for (k = 0; k < 5; k++) {
-        bool positionValide = false;
-        while (!positionValide) {
-            aleatX = rand() % (MAXTAB_X - 6) + 1; // Espace entre les bordures
-            aleatY = rand() % (MAXTAB_Y - 6) + 1;
+void initHorloge(t_horloge *horloge, int64_t periode, int rattrapage){
+    horloge->periode = periode;
+    horloge->echeance = maintenant() + periode;
+    horloge->rattrapage = rattrapage;
+    horloge->ticks = 0;
+    horloge->depassements = 0;
+    horloge->gigueMax = 0;
+    horloge->gigueTotale = 0;
+}
 
-            positionValide = true;
-            // Vérifier qu'il n'y a pas de collision avec les bords ou autres carrés
-            for (j = 0; j < 5 && positionValide; j++) {
-                for (i = 0; i < 5 && positionValide; i++) {
-                    if (plateau[aleatY + j][aleatX + i] != ESPACE) {
-                        positionValide = false;
-                    }
-                }
-            }
+void attendreJusqua(int64_t date){
+    struct timespec t;
 
-            // Vérifier qu'il n'y a pas de collision avec le serpent
-            for (j = 0; j < TAILLE_SERPENT && positionValide; j++) {
-                for (int y = 0; y < 5 && positionValide; y++) {
-                    for (int x = 0; x < 5 && positionValide; x++) {
-                        if (aleatX + x == lesX[j] && aleatY + y == lesY[j]) {
-                            positionValide = false;
-                        }
-                    }
-                }
-            }
-        }
+    t.tv_sec = date / 1000000000;
+    t.tv_nsec = date % 1000000000;
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &t, NULL) == EINTR) {
+        // Reprendre l'attente jusqu'à la même date absolue
+    }
+}
 
-        // Initialiser le carré une fois que la position est valide
-        for (j = 0; j < 5; j++) {
-            for (i = 0; i < 5; i++) {
-                plateau[aleatY + j][aleatX + i] = BORDURE;
-            }
-        }
+void attendreClavier(int64_t date){
+    int64_t reste;
+
+    while (clavier.debut == clavier.fin && (reste = date - maintenant()) >= 1000000) {
+        toucheDisponible((int)(reste / 1000000));
     }
+    attendreJusqua(date);
 }
 
-void dessinerPlateau(char plateau[MAXTAB_Y][MAXTAB_X]) {
-    int i, j;
-    for (i = 0; i < MAXTAB_Y; i++) { 
-        for (j = 0; j < MAXTAB_X; j++) {
-            afficher(j + 1, i + 1, plateau[i][j]);
-        }
+bool tickDu(t_horloge *horloge, int64_t date){
+    int64_t retard, manques;
+
+    if (date < horloge->echeance) {
+        return false;
     }
+    retard = date - horloge->echeance;
+    if (retard > horloge->gigueMax) {
+        horloge->gigueMax = retard;
+    }
+    horloge->gigueTotale += retard;
+    horloge->ticks++;
+
+    // Programmer le tick suivant, en sautant ceux qui ne seront pas rattrapés
+    horloge->echeance += horloge->periode;
+    if (date - horloge->echeance >= horloge->rattrapage * horloge->periode) {
+        manques = (date - horloge->echeance) / horloge->periode + 1 - horloge->rattrapage;
+        horloge->depassements += manques;
+        horloge->echeance += manques * horloge->periode;
+    }
+    return true;
 }
 
+void changerPeriode(t_horloge *horloge, int64_t periode){
+    horloge->echeance += periode - horloge->periode;
+    horloge->periode = periode;
+}
 
-void ajouterPomme(int lesX[], int lesY[]){
-    int aleatX, aleatY;
-    srand(time(NULL));
-    bool positionValide = false;
-    while (positionValide == false){
-            aleatX = (rand() % (MAXTAB_X - 2)) + 1;// créer des coordonnées aléatoire avec un espace entre les bordures et les carrés
-            aleatY = (rand() % (MAXTAB_Y - 2)) + 1;
+void reprendreHorloge(t_horloge *horloge){
+    horloge->echeance = maintenant() + horloge->periode;
+}
 
-            positionValide = true; // Boucle pour empecher les carrés d'apparaitre sur les bordures
-            if (plateau[aleatY][aleatX] != ESPACE) {
-                positionValide = false;
-            }
+int lireOption(const char *programme, const char *option, const char *texte, int min, int max){
+    int valeur;
 
-            for (int j = 0; j < TAILLE_SERPENT; j++) { // Boucle pour empecher les carrés d'apparaitre sur le serpent
-                if ((aleatX == lesX[j] && aleatY == lesY[j])) {
-                    positionValide = false;
-                }
-            }
+    if (!lireEntier(texte, min, max, &valeur)) {
+        fprintf(stderr, "%s : %s attend un entier entre %d et %d, pas « %s »\n", programme, option, min, max, texte);
+        exit(EXIT_FAILURE);
     }
-    plateau[aleatY][aleatX] = POMME;
-    afficher(aleatX, aleatY, POMME);
-}
\ No newline at end of file
+    return valeur;
+}